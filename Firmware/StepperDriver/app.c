@@ -12,6 +12,12 @@
 #include "i2c.h"
 #include "stepper_control.h"
 #include "quick_movement.h"
+#include "homing.h"
+#include "encoders.h"
+#include "telemetry.h"
+#include "closed_loop.h"
+#include "gearing.h"
+#include "feed_rate.h"
 
 /************************************************************************/
 /* Declare application registers                                        */
@@ -228,6 +234,11 @@ void core_callback_device_to_standby(void)
 	stop_rotation(1);
 	stop_rotation(2);
 	stop_rotation(3);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		pause_discard(i);
+	}
 }
 void core_callback_device_to_active(void) {}
 void core_callback_device_to_enchanced_active(void) {}
@@ -256,47 +267,90 @@ void core_callback_t_before_exec(void)
 {
 	acquisition_counter++;
 	
+	/* Sample the encoders and keep track of their overflows */
+	encoders_update();
+	
+	/* Compare the motors with their encoders */
+	closed_loop_process();
+	
+	/* Update the motors following the encoders */
+	gearing_process();
+	
 	if (encoders_enabled_mask)
 	{
-		if ((app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_500HZ && ((acquisition_counter & 3) == 0)) ||
+		if ((app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_2KHZ) ||
+			(app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_1KHZ && ((acquisition_counter & 1) == 0)))
+		{
+			/* Collect the samples and send them in a single event with the first sample's timestamp */
+			uint8_t sample_index = encoders_batch_add_sample(app_regs.REG_ENCODERS_BATCH, encoders_enabled_mask);
+			
+			if (sample_index == 0)
+			{
+				core_func_mark_user_timestamp();
+			}
+			
+			if (sample_index == ENCODERS_BATCH_SAMPLES - 1)
+			{
+				core_func_send_event(ADD_REG_ENCODERS_BATCH, false);
+			}
+		}
+		else if ((app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_500HZ && ((acquisition_counter & 3) == 0)) ||
 			(app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_250HZ && ((acquisition_counter & 7) == 0)) ||
 			(app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_200HZ && ((acquisition_counter % 10) == 0)) ||
 			(app_regs.REG_ENCODERS_UPDATE_RATE == GM_RATE_100HZ && ((acquisition_counter % 20) == 0)))
 		{
-			if (encoders_enabled_mask & B_ENCODER2)
+			/* With on-change enabled, only sends when the encoders moved more than the deadband */
+			if (telemetry_encoders_is_due())
 			{
-				int16_t timer_tcd1_cnt = TCD1_CNT;
+				/* All the encoders were sampled at the same instant by encoders_update() */
+				core_func_mark_user_timestamp();
 				
-				if (timer_tcd1_cnt > 32768)
-					app_regs.REG_ENCODERS[2] = 0xFFFF - timer_tcd1_cnt;
-				else
-					app_regs.REG_ENCODERS[2] = (32768 - timer_tcd1_cnt) * -1;
-			}
-			
-			if (encoders_enabled_mask & B_ENCODER0)			
-			{
-				int16_t timer_tce1_cnt = TCE1_CNT;
+				bool send_position = false;
+				bool send_velocity = false;
 				
-				if (timer_tce1_cnt > 32768)
-					app_regs.REG_ENCODERS[0] = 0xFFFF - timer_tce1_cnt;
-				else
-					app_regs.REG_ENCODERS[0] = (32768 - timer_tce1_cnt) * -1;
-			}			
-			
-			if (encoders_enabled_mask & B_ENCODER1)
-			{			
-				int16_t timer_tcf1_cnt = TCF1_CNT;
+				for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+				{
+					if (encoders_enabled_mask & (1 << i))
+					{
+						app_regs.REG_ENCODERS[i] = encoders_get_sampled_count(i);
+						
+						/* Each encoder's mode selects the events that are sent */
+						switch (encoders_get_mode(i))
+						{
+							case GM_ENCODER_EXTENDED:
+								app_regs.REG_ENCODERS_POSITION[i] = encoders_get_sampled_position(i);
+								send_position = true;
+								break;
+							
+							case GM_ENCODER_VELOCITY:
+								app_regs.REG_ENCODERS_VELOCITY[i] = encoders_get_velocity(i);
+								send_velocity = true;
+								break;
+							
+							case GM_ENCODER_INDEX_RESET:
+								app_regs.REG_ENCODERS_POSITION[i] = encoders_get_sampled_index_position(i);
+								send_position = true;
+								break;
+						}
+					}
+				}
 				
-				if (timer_tcf1_cnt > 32768)
-					app_regs.REG_ENCODERS[1] = 0xFFFF - timer_tcf1_cnt;
-				else
-					app_regs.REG_ENCODERS[1] = (32768 - timer_tcf1_cnt) * -1;
+				/* The positions are already streamed by the compact telemetry */
+				if (!telemetry_delta_stream_is_enabled())
+				{
+					core_func_send_event(ADD_REG_ENCODERS, false);
+					
+					if (send_position)
+						core_func_send_event(ADD_REG_ENCODERS_POSITION, false);
+				}
+				if (send_velocity)
+					core_func_send_event(ADD_REG_ENCODERS_VELOCITY, false);
 			}
-			
-			core_func_send_event(ADD_REG_ENCODERS, true);
 		}
 	}
 	
+	telemetry_process();
+	
 	if (enable_counter)
 	{
 		if ((read_EMERGENCY == false && app_regs.REG_EMERGENCY_DETECTION_MODE == GM_CLOSED) || (read_EMERGENCY == true && app_regs.REG_EMERGENCY_DETECTION_MODE == GM_OPEN))
@@ -328,9 +382,15 @@ void core_callback_t_before_exec(void)
 		{
 			send_motor_stopped_notification[i] = false;
 			
-			motors_mask |= (1<<i);
+			/* While homing, the stops are reported by the homing event */
+			/* While correcting the position, the stop is reported when the correction ends */
+			if (!homing_is_running(i) && closed_loop_motor_stopped(i))
+			{
+				motors_mask |= (1<<i);
+			}
 		}		
 	}	
+	motors_mask |= closed_loop_take_stopped_motors();
 	if (motors_mask)
 	{		
 		send_motors_stopped_event(motors_mask);
@@ -363,7 +423,12 @@ void core_callback_t_after_exec(void)
 			(app_regs.REG_ACCUMULATED_STEPS_UPDATE_RATE == GM_AS_RATE_50HZ  && ((acquisition_counter % 40)  == 0)) ||
 			(app_regs.REG_ACCUMULATED_STEPS_UPDATE_RATE == GM_AS_RATE_100HZ && ((acquisition_counter % 20)  == 0)))
 		{
-			core_func_send_event(ADD_REG_ACCUMULATED_STEPS, true);
+			/* With on-change enabled, only sends when the steps changed more than the deadband */
+			/* The steps are already streamed by the compact telemetry */
+			if (!telemetry_delta_stream_is_enabled() && telemetry_accumulated_steps_is_due())
+			{
+				core_func_send_event(ADD_REG_ACCUMULATED_STEPS, true);
+			}
 		}
 	}
 }
@@ -470,6 +535,15 @@ void core_callback_t_1ms(void)
 		
 		PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
 	}
+	
+	/* Advance the homing sequences */
+	homing_process();
+	
+	/* Stop the immediate steps when the host stops updating them */
+	immediate_steps_watchdog_process();
+	
+	/* Slew the speed overrides of the running moves */
+	feed_rate_process();
 }
 
 /************************************************************************/
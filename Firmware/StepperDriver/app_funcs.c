@@ -5,6 +5,14 @@
 #include "i2c.h"
 #include "stepper_control.h"
 #include "quick_movement.h"
+#include "homing.h"
+#include "triggered_move.h"
+#include "encoders.h"
+#include "telemetry.h"
+#include "closed_loop.h"
+#include "gearing.h"
+#include "feed_rate.h"
+#include "blended_move.h"
 
 #define PERIOD_LIMIT 100
 
@@ -194,7 +202,59 @@ void (*app_func_rd_pointer[])(void) = {
 	&app_read_REG_MOTOR1_QUICK_ACCELERATION,
 	&app_read_REG_MOTOR2_QUICK_ACCELERATION,
 	&app_read_REG_MOTOR1_QUICK_DISTANCE,
-	&app_read_REG_MOTOR2_QUICK_DISTANCE
+	&app_read_REG_MOTOR2_QUICK_DISTANCE,
+	&app_read_REG_MOTORS_MAXIMUM_CURRENT_RMS,
+	&app_read_REG_START_HOMING,
+	&app_read_REG_HOMING_CONFIGURATION,
+	&app_read_REG_HOMING_FAST_STEP_INTERVAL,
+	&app_read_REG_HOMING_SLOW_STEP_INTERVAL,
+	&app_read_REG_HOMING_BACK_OFF_STEPS,
+	&app_read_REG_HOMING_MAXIMUM_STEPS,
+	&app_read_REG_HOMING_DONE,
+	&app_read_REG_POSITION_LATCH_MODE,
+	&app_read_REG_LATCHED_POSITIONS,
+	&app_read_REG_TRIGGERED_MOVE_CONFIGURATION,
+	&app_read_REG_TRIGGERED_MOVE_STEPS,
+	&app_read_REG_ARM_TRIGGERED_MOVES,
+	&app_read_REG_ENCODERS_POSITION,
+	&app_read_REG_ENCODERS_VELOCITY,
+	&app_read_REG_ENCODERS_BATCH,
+	&app_read_REG_TELEMETRY_MODE,
+	&app_read_REG_TELEMETRY_RATE,
+	&app_read_REG_TELEMETRY_KEYFRAME_INTERVAL,
+	&app_read_REG_TELEMETRY_KEYFRAME,
+	&app_read_REG_TELEMETRY_DELTAS,
+	&app_read_REG_EVENTS_ON_CHANGE,
+	&app_read_REG_ACCUMULATED_STEPS_DEADBAND,
+	&app_read_REG_ENCODERS_DEADBAND,
+	&app_read_REG_EVENTS_HEARTBEAT_INTERVAL,
+	&app_read_REG_TELEMETRY_FRAME_FIELDS,
+	&app_read_REG_TELEMETRY_FRAME,
+	&app_read_REG_MOTORS_STEPS_PER_COUNT,
+	&app_read_REG_FOLLOWING_ERROR_THRESHOLD,
+	&app_read_REG_FOLLOWING_ERROR_STOP_MOTORS,
+	&app_read_REG_FOLLOWING_ERROR,
+	&app_read_REG_FOLLOWING_ERROR_DETECTED,
+	&app_read_REG_POSITION_CORRECTION_TOLERANCE,
+	&app_read_REG_POSITION_CORRECTION,
+	&app_read_REG_GEARING_CONFIGURATION,
+	&app_read_REG_GEARING_RATIO,
+	&app_read_REG_GEARING_MAXIMUM_SPEED,
+	&app_read_REG_GEARING_ACCELERATION,
+	&app_read_REG_ENCODERS_INDEX_CONFIGURATION,
+	&app_read_REG_ENCODERS_CONFIGURATION,
+	&app_read_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL,
+	&app_read_REG_IMMEDIATE_STEPS_TIMEOUT,
+	&app_read_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED,
+	&app_read_REG_FEED_RATE_OVERRIDE,
+	&app_read_REG_MOTORS_FEED_RATE_OVERRIDE,
+	&app_read_REG_PAUSE_MOVES,
+	&app_read_REG_RESUME_MOVES,
+	&app_read_REG_BLENDED_MOVE_STEP_INTERVAL,
+	&app_read_REG_BLENDED_MOVE_STEPS,
+	&app_read_REG_BLENDED_MOVES_PENDING,
+	&app_read_REG_BACKLASH_STEPS,
+	&app_read_REG_TELEMETRY_WIDE_DELTAS
 };
 
 bool (*app_func_wr_pointer[])(void*) = {
@@ -306,7 +366,59 @@ bool (*app_func_wr_pointer[])(void*) = {
 	&app_write_REG_MOTOR1_QUICK_ACCELERATION,
 	&app_write_REG_MOTOR2_QUICK_ACCELERATION,
 	&app_write_REG_MOTOR1_QUICK_DISTANCE,
-	&app_write_REG_MOTOR2_QUICK_DISTANCE
+	&app_write_REG_MOTOR2_QUICK_DISTANCE,
+	&app_write_REG_MOTORS_MAXIMUM_CURRENT_RMS,
+	&app_write_REG_START_HOMING,
+	&app_write_REG_HOMING_CONFIGURATION,
+	&app_write_REG_HOMING_FAST_STEP_INTERVAL,
+	&app_write_REG_HOMING_SLOW_STEP_INTERVAL,
+	&app_write_REG_HOMING_BACK_OFF_STEPS,
+	&app_write_REG_HOMING_MAXIMUM_STEPS,
+	&app_write_REG_HOMING_DONE,
+	&app_write_REG_POSITION_LATCH_MODE,
+	&app_write_REG_LATCHED_POSITIONS,
+	&app_write_REG_TRIGGERED_MOVE_CONFIGURATION,
+	&app_write_REG_TRIGGERED_MOVE_STEPS,
+	&app_write_REG_ARM_TRIGGERED_MOVES,
+	&app_write_REG_ENCODERS_POSITION,
+	&app_write_REG_ENCODERS_VELOCITY,
+	&app_write_REG_ENCODERS_BATCH,
+	&app_write_REG_TELEMETRY_MODE,
+	&app_write_REG_TELEMETRY_RATE,
+	&app_write_REG_TELEMETRY_KEYFRAME_INTERVAL,
+	&app_write_REG_TELEMETRY_KEYFRAME,
+	&app_write_REG_TELEMETRY_DELTAS,
+	&app_write_REG_EVENTS_ON_CHANGE,
+	&app_write_REG_ACCUMULATED_STEPS_DEADBAND,
+	&app_write_REG_ENCODERS_DEADBAND,
+	&app_write_REG_EVENTS_HEARTBEAT_INTERVAL,
+	&app_write_REG_TELEMETRY_FRAME_FIELDS,
+	&app_write_REG_TELEMETRY_FRAME,
+	&app_write_REG_MOTORS_STEPS_PER_COUNT,
+	&app_write_REG_FOLLOWING_ERROR_THRESHOLD,
+	&app_write_REG_FOLLOWING_ERROR_STOP_MOTORS,
+	&app_write_REG_FOLLOWING_ERROR,
+	&app_write_REG_FOLLOWING_ERROR_DETECTED,
+	&app_write_REG_POSITION_CORRECTION_TOLERANCE,
+	&app_write_REG_POSITION_CORRECTION,
+	&app_write_REG_GEARING_CONFIGURATION,
+	&app_write_REG_GEARING_RATIO,
+	&app_write_REG_GEARING_MAXIMUM_SPEED,
+	&app_write_REG_GEARING_ACCELERATION,
+	&app_write_REG_ENCODERS_INDEX_CONFIGURATION,
+	&app_write_REG_ENCODERS_CONFIGURATION,
+	&app_write_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL,
+	&app_write_REG_IMMEDIATE_STEPS_TIMEOUT,
+	&app_write_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED,
+	&app_write_REG_FEED_RATE_OVERRIDE,
+	&app_write_REG_MOTORS_FEED_RATE_OVERRIDE,
+	&app_write_REG_PAUSE_MOVES,
+	&app_write_REG_RESUME_MOVES,
+	&app_write_REG_BLENDED_MOVE_STEP_INTERVAL,
+	&app_write_REG_BLENDED_MOVE_STEPS,
+	&app_write_REG_BLENDED_MOVES_PENDING,
+	&app_write_REG_BACKLASH_STEPS,
+	&app_write_REG_TELEMETRY_WIDE_DELTAS
 };
 
 
@@ -1079,17 +1191,33 @@ bool app_write_REG_MOTOR3_STEP_ACCELERATION_INTERVAL(void *a)
 /************************************************************************/
 /* REG_ENCODERS_MODE                                                    */
 /************************************************************************/
-void app_read_REG_ENCODERS_MODE(void)
-{
-	//app_regs.REG_ENCODERS_MODE = 0;
-
-}
-
+void app_read_REG_ENCODERS_MODE(void) {}
 bool app_write_REG_ENCODERS_MODE(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
-
+	uint8_t index_mask = 0;
+	
+	/* Two bits for each of the 3 encoders */
+	if (reg & 0xC0) return false;
+	
+	/* Encoders already in index mode keep their position since the last index pulse */
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (encoders_get_mode(i) != GM_ENCODER_INDEX_RESET)
+			index_mask |= (1 << i);
+	}
+	
 	app_regs.REG_ENCODERS_MODE = reg;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (encoders_get_mode(i) != GM_ENCODER_INDEX_RESET)
+			index_mask &= ~(1 << i);
+	}
+	
+	/* The position since the index pulse starts at zero until the first pulse */
+	encoders_index_restart(index_mask);
+	
 	return true;
 }
 
@@ -1101,12 +1229,32 @@ void app_read_REG_ENCODERS_UPDATE_RATE(void) {}
 bool app_write_REG_ENCODERS_UPDATE_RATE(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg > GM_RATE_2KHZ) return false;
+	
+	encoders_batch_restart();
 
 	app_regs.REG_ENCODERS_UPDATE_RATE = reg;
 	return true;
 }
 
 
+/************************************************************************/
+/* REG_INPUTn_OPERATION_MODE                                            */
+/************************************************************************/
+static bool input_operation_mode_is_valid(uint8_t mode)
+{
+	/* Any combination of bits is valid in the motors mask form */
+	if (mode & B_INPUT_STOP_MOTORS_MASK) return true;
+	
+	if (mode == GM_EVENT_ONLY) return true;
+	if ((mode & ~MSK_INPUT_STOP_MOTOR_INDEX) == GM_STOP_MOTOR0_ON_RISING) return true;
+	if ((mode & ~MSK_INPUT_STOP_MOTOR_INDEX) == GM_STOP_MOTOR0_ON_FALLING) return true;
+	
+	return false;
+}
+
+
 /************************************************************************/
 /* REG_INPUT0_OPERATION_MODE                                            */
 /************************************************************************/
@@ -1114,6 +1262,8 @@ void app_read_REG_INPUT0_OPERATION_MODE(void) {}
 bool app_write_REG_INPUT0_OPERATION_MODE(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
+	
+	if (!input_operation_mode_is_valid(reg)) return false;
 
 	app_regs.REG_INPUT0_OPERATION_MODE = reg;
 	return true;
@@ -1127,6 +1277,8 @@ void app_read_REG_INPUT1_OPERATION_MODE(void) {}
 bool app_write_REG_INPUT1_OPERATION_MODE(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
+	
+	if (!input_operation_mode_is_valid(reg)) return false;
 
 	app_regs.REG_INPUT1_OPERATION_MODE = reg;
 	return true;
@@ -1140,6 +1292,8 @@ void app_read_REG_INPUT2_OPERATION_MODE(void) {}
 bool app_write_REG_INPUT2_OPERATION_MODE(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
+	
+	if (!input_operation_mode_is_valid(reg)) return false;
 
 	app_regs.REG_INPUT2_OPERATION_MODE = reg;
 	return true;
@@ -1153,6 +1307,8 @@ void app_read_REG_INPUT3_OPERATION_MODE(void) {}
 bool app_write_REG_INPUT3_OPERATION_MODE(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
+	
+	if (!input_operation_mode_is_valid(reg)) return false;
 
 	app_regs.REG_INPUT3_OPERATION_MODE = reg;
 	return true;
@@ -1588,6 +1744,8 @@ bool app_write_REG_ACCUMULATED_STEPS(void *a)
 	app_regs.REG_ACCUMULATED_STEPS[1] = reg[1];
 	app_regs.REG_ACCUMULATED_STEPS[2] = reg[2];
 	app_regs.REG_ACCUMULATED_STEPS[3] = reg[3];
+	
+	closed_loop_resync(B_MOTOR0 | B_MOTOR1 | B_MOTOR2);
 	return true;
 }
 
@@ -1606,6 +1764,8 @@ bool app_write_REG_MOTOR0_ACCUMULATED_STEPS(void *a)
 	
 	app_regs.REG_ACCUMULATED_STEPS[0] = reg;
 	app_regs.REG_MOTOR0_ACCUMULATED_STEPS = reg;
+	
+	closed_loop_resync(B_MOTOR0);
 	return true;
 }
 
@@ -1624,6 +1784,8 @@ bool app_write_REG_MOTOR1_ACCUMULATED_STEPS(void *a)
 	
 	app_regs.REG_ACCUMULATED_STEPS[1] = reg;
 	app_regs.REG_MOTOR1_ACCUMULATED_STEPS = reg;
+	
+	closed_loop_resync(B_MOTOR1);
 	return true;
 }
 
@@ -1643,6 +1805,8 @@ bool app_write_REG_MOTOR2_ACCUMULATED_STEPS(void *a)
 
 	app_regs.REG_ACCUMULATED_STEPS[2] = reg;
 	app_regs.REG_MOTOR2_ACCUMULATED_STEPS = reg;
+	
+	closed_loop_resync(B_MOTOR2);
 	return true;
 }
 
@@ -1682,6 +1846,12 @@ bool app_write_REG_MOTORS_MAX_STEPS_INTEGRATION(void *a)
 	app_regs.REG_MOTORS_MAX_STEPS_INTEGRATION[1] = reg[1];
 	app_regs.REG_MOTORS_MAX_STEPS_INTEGRATION[2] = reg[2];
 	app_regs.REG_MOTORS_MAX_STEPS_INTEGRATION[3] = reg[3];
+	
+	/* Running moves decelerate to end on the new limits */
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		travel_limits_update(i);
+	}
 	return true;
 }
 
@@ -1695,6 +1865,7 @@ bool app_write_REG_MOTOR0_MAX_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION = reg;
+	travel_limits_update(0);
 	return true;
 }
 
@@ -1708,6 +1879,7 @@ bool app_write_REG_MOTOR1_MAX_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR1_MAX_STEPS_INTEGRATION = reg;
+	travel_limits_update(1);
 	return true;
 }
 
@@ -1721,6 +1893,7 @@ bool app_write_REG_MOTOR2_MAX_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR2_MAX_STEPS_INTEGRATION = reg;
+	travel_limits_update(2);
 	return true;
 }
 
@@ -1734,6 +1907,7 @@ bool app_write_REG_MOTOR3_MAX_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR3_MAX_STEPS_INTEGRATION = reg;
+	travel_limits_update(3);
 	return true;
 }
 
@@ -1755,6 +1929,12 @@ bool app_write_REG_MOTORS_MIN_STEPS_INTEGRATION(void *a)
 	app_regs.REG_MOTORS_MIN_STEPS_INTEGRATION[1] = reg[1];
 	app_regs.REG_MOTORS_MIN_STEPS_INTEGRATION[2] = reg[2];
 	app_regs.REG_MOTORS_MIN_STEPS_INTEGRATION[3] = reg[3];
+	
+	/* Running moves decelerate to end on the new limits */
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		travel_limits_update(i);
+	}
 	return true;
 }
 
@@ -1768,6 +1948,7 @@ bool app_write_REG_MOTOR0_MIN_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION = reg;
+	travel_limits_update(0);
 	return true;
 }
 
@@ -1781,6 +1962,7 @@ bool app_write_REG_MOTOR1_MIN_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR1_MIN_STEPS_INTEGRATION = reg;
+	travel_limits_update(1);
 	return true;
 }
 
@@ -1794,6 +1976,7 @@ bool app_write_REG_MOTOR2_MIN_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR2_MIN_STEPS_INTEGRATION = reg;
+	travel_limits_update(2);
 	return true;
 }
 
@@ -1807,6 +1990,7 @@ bool app_write_REG_MOTOR3_MIN_STEPS_INTEGRATION(void *a)
 	int32_t reg = *((int32_t*)a);
 
 	app_regs.REG_MOTOR3_MIN_STEPS_INTEGRATION = reg;
+	travel_limits_update(3);
 	return true;
 }
 
@@ -1819,10 +2003,14 @@ bool app_write_REG_MOTORS_IMMEDIATE_STEPS(void *a)
 {
 	int32_t *reg = ((int32_t*)a);
 	
-	if (reg[0]) if (read_DRIVE_ENABLE_M0) return false;
-	if (reg[1]) if (read_DRIVE_ENABLE_M1) return false;
-	if (reg[2]) if (read_DRIVE_ENABLE_M2) return false;
-	if (reg[3]) if (read_DRIVE_ENABLE_M3) return false;
+	if (reg[0]) if (read_DRIVE_ENABLE_M0 || gearing_is_running(0)) return false;
+	if (reg[1]) if (read_DRIVE_ENABLE_M1 || gearing_is_running(1)) return false;
+	if (reg[2]) if (read_DRIVE_ENABLE_M2 || gearing_is_running(2)) return false;
+	if (reg[3]) if (read_DRIVE_ENABLE_M3 || gearing_is_running(3)) return false;
+	
+	/* The homing sequence can't be taken over */
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+		if (homing_is_running(i)) return false;
 	
 	app_write_REG_MOTOR0_IMMEDIATE_STEPS(reg+0);
 	app_write_REG_MOTOR1_IMMEDIATE_STEPS(reg+1);
@@ -1845,14 +2033,20 @@ bool app_write_REG_MOTOR0_IMMEDIATE_STEPS(void *a)
 {
 	int32_t reg = *((int32_t*)a);
 	
-	if (reg) if (read_DRIVE_ENABLE_M0) return false;
+	if (reg) if (read_DRIVE_ENABLE_M0 || gearing_is_running(0)) return false;
+	if (homing_is_running(0)) return false;
 	
 	if (reg > -PERIOD_LIMIT && reg < PERIOD_LIMIT)
 	{
 		reg = 0;
 	}
 	
-	if (reg == 0)
+	if (app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[0])
+	{
+		/* The step interrupt slews the speed to the new interval */
+		immediate_steps_ramp(reg, app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[0], 0);
+	}
+	else if (reg == 0)
 	{
 		timer_type0_stop(&TCC0);
 		clr_LED_M0;
@@ -1893,6 +2087,9 @@ bool app_write_REG_MOTOR0_IMMEDIATE_STEPS(void *a)
 		TCC0_CCA = 3;
 	}
 
+	/* Each update restarts the host link timeout */
+	immediate_steps_watchdog_feed(0, (reg != 0) ? true : false);
+
 	app_regs.REG_MOTOR0_IMMEDIATE_STEPS = *((int32_t*)a);
 	return true;
 }
@@ -1906,14 +2103,20 @@ bool app_write_REG_MOTOR1_IMMEDIATE_STEPS(void *a)
 {
 	int32_t reg = *((int32_t*)a);
 	
-	if (reg) if (read_DRIVE_ENABLE_M1) return false;
+	if (reg) if (read_DRIVE_ENABLE_M1 || gearing_is_running(1)) return false;
+	if (homing_is_running(1)) return false;
 	
 	if (reg > -PERIOD_LIMIT && reg < PERIOD_LIMIT)
 	{
 		reg = 0;
 	}
 	
-	if (reg == 0)
+	if (app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[1])
+	{
+		/* The step interrupt slews the speed to the new interval */
+		immediate_steps_ramp(reg, app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[1], 1);
+	}
+	else if (reg == 0)
 	{
 		timer_type0_stop(&TCD0);
 		clr_LED_M1;
@@ -1954,6 +2157,9 @@ bool app_write_REG_MOTOR1_IMMEDIATE_STEPS(void *a)
 		TCC0_CCA = 3;
 	}
 
+	/* Each update restarts the host link timeout */
+	immediate_steps_watchdog_feed(1, (reg != 0) ? true : false);
+
 	app_regs.REG_MOTOR1_IMMEDIATE_STEPS = *((int32_t*)a);
 	return true;
 }
@@ -1967,14 +2173,20 @@ bool app_write_REG_MOTOR2_IMMEDIATE_STEPS(void *a)
 {
 	int32_t reg = *((int32_t*)a);
 	
-	if (reg) if (read_DRIVE_ENABLE_M2) return false;
+	if (reg) if (read_DRIVE_ENABLE_M2 || gearing_is_running(2)) return false;
+	if (homing_is_running(2)) return false;
 	
 	if (reg > -PERIOD_LIMIT && reg < PERIOD_LIMIT)
 	{
 		reg = 0;
 	}
 	
-	if (reg == 0)
+	if (app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[2])
+	{
+		/* The step interrupt slews the speed to the new interval */
+		immediate_steps_ramp(reg, app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[2], 2);
+	}
+	else if (reg == 0)
 	{
 		timer_type0_stop(&TCE0);
 		clr_LED_M2;
@@ -2015,6 +2227,9 @@ bool app_write_REG_MOTOR2_IMMEDIATE_STEPS(void *a)
 		TCC0_CCA = 3;
 	}
 
+	/* Each update restarts the host link timeout */
+	immediate_steps_watchdog_feed(2, (reg != 0) ? true : false);
+
 	app_regs.REG_MOTOR2_IMMEDIATE_STEPS = *((int32_t*)a);
 	return true;
 }
@@ -2028,14 +2243,20 @@ bool app_write_REG_MOTOR3_IMMEDIATE_STEPS(void *a)
 {
 	int32_t reg = *((int32_t*)a);
 	
-	if (reg) if (read_DRIVE_ENABLE_M3) return false;
+	if (reg) if (read_DRIVE_ENABLE_M3 || gearing_is_running(3)) return false;
+	if (homing_is_running(3)) return false;
 	
 	if (reg > -PERIOD_LIMIT && reg < PERIOD_LIMIT)
 	{
 		reg = 0;
 	}
 	
-	if (reg == 0)
+	if (app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[3])
+	{
+		/* The step interrupt slews the speed to the new interval */
+		immediate_steps_ramp(reg, app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[3], 3);
+	}
+	else if (reg == 0)
 	{
 		timer_type0_stop(&TCF0);
 		clr_LED_M3;
@@ -2076,6 +2297,9 @@ bool app_write_REG_MOTOR3_IMMEDIATE_STEPS(void *a)
 		TCC0_CCA = 3;
 	}
 
+	/* Each update restarts the host link timeout */
+	immediate_steps_watchdog_feed(3, (reg != 0) ? true : false);
+
 	app_regs.REG_MOTOR3_IMMEDIATE_STEPS = *((int32_t*)a);
 	return true;
 }
@@ -2093,6 +2317,12 @@ bool app_write_REG_STOP_MOTORS_SUDENTLY(void *a)
 	if (reg & B_MOTOR1) stop_rotation (1);
 	if (reg & B_MOTOR2) stop_rotation (2);
 	if (reg & B_MOTOR3) stop_rotation (3);
+	
+	/* A paused move is also cancelled */
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg & (1 << i)) pause_discard(i);
+	}
 
 	app_regs.REG_STOP_MOTORS_SUDENTLY = reg;
 	return true;
@@ -2129,9 +2359,10 @@ bool app_write_REG_RESET_ENCODERS(void *a)
 {
 	uint8_t reg = *((uint8_t*)a);
 	
-	if (reg & B_ENCODER0) TCE1_CNT = 0x8000;
-	if (reg & B_ENCODER1) TCF1_CNT = 0x8000;
-	if (reg & B_ENCODER2) TCD1_CNT = 0x8000;
+	encoders_reset(reg);
+	
+	/* The encoders of motors 0 to 2 have the same index */
+	closed_loop_resync(reg);
 
 	app_regs.REG_RESET_ENCODERS = reg;
 	return true;
@@ -2662,4 +2893,977 @@ bool app_write_REG_MOTOR2_QUICK_DISTANCE(void *a)
 	//m1_recalc_internal_paramenters();
 	
 	return true;
+}
+
+
+/************************************************************************/
+/* REG_MOTORS_MAXIMUM_CURRENT_RMS                                       */
+/************************************************************************/
+void app_read_REG_MOTORS_MAXIMUM_CURRENT_RMS(void)
+{
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[0] = app_regs.REG_MOTOR0_MAXIMUM_CURRENT_RMS;
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[1] = app_regs.REG_MOTOR1_MAXIMUM_CURRENT_RMS;
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[2] = app_regs.REG_MOTOR2_MAXIMUM_CURRENT_RMS;
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[3] = app_regs.REG_MOTOR3_MAXIMUM_CURRENT_RMS;
+}
+
+bool app_write_REG_MOTORS_MAXIMUM_CURRENT_RMS(void *a)
+{
+	float *reg = ((float*)a);
+	
+	uint8_t cfg_2_and_3[4];
+	uint8_t digital_pot[4];
+	
+	digital_pot[0] = calculate_max_current_configuration_data (&cfg_2_and_3[0], reg[0]);
+	digital_pot[1] = calculate_max_current_configuration_data (&cfg_2_and_3[1], reg[1]);
+	digital_pot[2] = calculate_max_current_configuration_data (&cfg_2_and_3[2], reg[2]);
+	digital_pot[3] = calculate_max_current_configuration_data (&cfg_2_and_3[3], reg[3]);
+	
+	if (cfg_2_and_3[0] & 1) set_CFG2_M0; else clr_CFG2_M0;
+	if (cfg_2_and_3[0] & 2) set_CFG3_M0; else clr_CFG3_M0;
+	if (cfg_2_and_3[1] & 1) set_CFG2_M1; else clr_CFG2_M1;
+	if (cfg_2_and_3[1] & 2) set_CFG3_M1; else clr_CFG3_M1;
+	if (cfg_2_and_3[2] & 1) set_CFG2_M2; else clr_CFG2_M2;
+	if (cfg_2_and_3[2] & 2) set_CFG3_M2; else clr_CFG3_M2;
+	if (cfg_2_and_3[3] & 1) set_CFG2_M3; else clr_CFG2_M3;
+	if (cfg_2_and_3[3] & 2) set_CFG3_M3; else clr_CFG3_M3;
+	
+	/* Both wipers of each potentiometer are updated in one bus transaction */
+	digi_pot_M0_M1.data[0] = 0x00;		// Pot 1
+	digi_pot_M0_M1.data[1] = digital_pot[0];
+	digi_pot_M0_M1.data[2] = 0x80;		// Pot 2
+	digi_pot_M0_M1.data[3] = digital_pot[1];
+	
+	digi_pot_M2_M3.data[0] = 0x00;		// Pot 1
+	digi_pot_M2_M3.data[1] = digital_pot[2];
+	digi_pot_M2_M3.data[2] = 0x80;		// Pot 2
+	digi_pot_M2_M3.data[3] = digital_pot[3];
+	
+	bool ok = i2c0_wRegs(&digi_pot_M0_M1, 2);
+	ok &= i2c0_wRegs(&digi_pot_M2_M3, 2);
+	
+	app_regs.REG_RESERVED4 = digital_pot[0];
+	app_regs.REG_RESERVED5 = digital_pot[1];
+	app_regs.REG_RESERVED6 = digital_pot[2];
+	app_regs.REG_RESERVED7 = digital_pot[3];
+	
+	app_regs.REG_MOTOR0_MAXIMUM_CURRENT_RMS = reg[0];
+	app_regs.REG_MOTOR1_MAXIMUM_CURRENT_RMS = reg[1];
+	app_regs.REG_MOTOR2_MAXIMUM_CURRENT_RMS = reg[2];
+	app_regs.REG_MOTOR3_MAXIMUM_CURRENT_RMS = reg[3];
+	
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[0] = reg[0];
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[1] = reg[1];
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[2] = reg[2];
+	app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS[3] = reg[3];
+	return ok;
+}
+
+
+/************************************************************************/
+/* REG_START_HOMING                                                     */
+/************************************************************************/
+void app_read_REG_START_HOMING(void)
+{
+	app_regs.REG_START_HOMING = 0;
+	
+	if (homing_is_running(0)) app_regs.REG_START_HOMING |= B_MOTOR0;
+	if (homing_is_running(1)) app_regs.REG_START_HOMING |= B_MOTOR1;
+	if (homing_is_running(2)) app_regs.REG_START_HOMING |= B_MOTOR2;
+	if (homing_is_running(3)) app_regs.REG_START_HOMING |= B_MOTOR3;
+}
+
+bool app_write_REG_START_HOMING(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if ((reg & B_MOTOR0) && read_DRIVE_ENABLE_M0) return false;
+	if ((reg & B_MOTOR1) && read_DRIVE_ENABLE_M1) return false;
+	if ((reg & B_MOTOR2) && read_DRIVE_ENABLE_M2) return false;
+	if ((reg & B_MOTOR3) && read_DRIVE_ENABLE_M3) return false;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg & (1 << i))
+		{
+			if (homing_is_running(i)) return false;
+			if (is_timer_ready(i) == false) return false;
+			if (app_regs.REG_HOMING_BACK_OFF_STEPS[i] == 0) return false;
+			if (homing_input_is_enabled(i) == false) return false;
+		}
+	}
+	
+	if (reg & B_MOTOR0) homing_start(0);
+	if (reg & B_MOTOR1) homing_start(1);
+	if (reg & B_MOTOR2) homing_start(2);
+	if (reg & B_MOTOR3) homing_start(3);
+
+	app_regs.REG_START_HOMING = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_HOMING_CONFIGURATION                                             */
+/************************************************************************/
+void app_read_REG_HOMING_CONFIGURATION(void) {}
+bool app_write_REG_HOMING_CONFIGURATION(void *a)
+{
+	uint8_t *reg = ((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] & ~(MSK_HOMING_INPUT | B_HOMING_POSITIVE_DIRECTION | B_HOMING_ON_FALLING)) return false;
+		if (homing_is_running(i)) return false;
+	}
+
+	app_regs.REG_HOMING_CONFIGURATION[0] = reg[0];
+	app_regs.REG_HOMING_CONFIGURATION[1] = reg[1];
+	app_regs.REG_HOMING_CONFIGURATION[2] = reg[2];
+	app_regs.REG_HOMING_CONFIGURATION[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_HOMING_FAST_STEP_INTERVAL                                        */
+/************************************************************************/
+void app_read_REG_HOMING_FAST_STEP_INTERVAL(void) {}
+bool app_write_REG_HOMING_FAST_STEP_INTERVAL(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] < PERIOD_LIMIT) return false;
+		if (reg[i] > 20000) return false;
+	}
+
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[0] = reg[0];
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[1] = reg[1];
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[2] = reg[2];
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_HOMING_SLOW_STEP_INTERVAL                                        */
+/************************************************************************/
+void app_read_REG_HOMING_SLOW_STEP_INTERVAL(void) {}
+bool app_write_REG_HOMING_SLOW_STEP_INTERVAL(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] < PERIOD_LIMIT) return false;
+		if (reg[i] > 20000) return false;
+	}
+
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[0] = reg[0];
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[1] = reg[1];
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[2] = reg[2];
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_HOMING_BACK_OFF_STEPS                                            */
+/************************************************************************/
+void app_read_REG_HOMING_BACK_OFF_STEPS(void) {}
+bool app_write_REG_HOMING_BACK_OFF_STEPS(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+
+	app_regs.REG_HOMING_BACK_OFF_STEPS[0] = reg[0];
+	app_regs.REG_HOMING_BACK_OFF_STEPS[1] = reg[1];
+	app_regs.REG_HOMING_BACK_OFF_STEPS[2] = reg[2];
+	app_regs.REG_HOMING_BACK_OFF_STEPS[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_HOMING_MAXIMUM_STEPS                                             */
+/************************************************************************/
+void app_read_REG_HOMING_MAXIMUM_STEPS(void) {}
+bool app_write_REG_HOMING_MAXIMUM_STEPS(void *a)
+{
+	uint32_t *reg = ((uint32_t*)a);
+
+	app_regs.REG_HOMING_MAXIMUM_STEPS[0] = reg[0];
+	app_regs.REG_HOMING_MAXIMUM_STEPS[1] = reg[1];
+	app_regs.REG_HOMING_MAXIMUM_STEPS[2] = reg[2];
+	app_regs.REG_HOMING_MAXIMUM_STEPS[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_HOMING_DONE                                                      */
+/************************************************************************/
+void app_read_REG_HOMING_DONE(void) {}
+bool app_write_REG_HOMING_DONE(void *a)
+{
+	return false;
+}
+
+/************************************************************************/
+/* REG_POSITION_LATCH_MODE                                              */
+/************************************************************************/
+void app_read_REG_POSITION_LATCH_MODE(void) {}
+bool app_write_REG_POSITION_LATCH_MODE(void *a)
+{
+	app_regs.REG_POSITION_LATCH_MODE = *((uint8_t*)a);
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_LATCHED_POSITIONS                                                */
+/************************************************************************/
+void app_read_REG_LATCHED_POSITIONS(void) {}
+bool app_write_REG_LATCHED_POSITIONS(void *a)
+{
+	return false;
+}
+
+/************************************************************************/
+/* REG_TRIGGERED_MOVE_CONFIGURATION                                     */
+/************************************************************************/
+void app_read_REG_TRIGGERED_MOVE_CONFIGURATION(void) {}
+bool app_write_REG_TRIGGERED_MOVE_CONFIGURATION(void *a)
+{
+	uint8_t *reg = ((uint8_t*)a);
+	
+	/* Changing the configuration disarms all the inputs */
+	triggered_move_arm(0);
+
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[0] = reg[0];
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[1] = reg[1];
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[2] = reg[2];
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_TRIGGERED_MOVE_STEPS                                             */
+/************************************************************************/
+void app_read_REG_TRIGGERED_MOVE_STEPS(void) {}
+bool app_write_REG_TRIGGERED_MOVE_STEPS(void *a)
+{
+	int32_t *reg = ((int32_t*)a);
+
+	app_regs.REG_TRIGGERED_MOVE_STEPS[0] = reg[0];
+	app_regs.REG_TRIGGERED_MOVE_STEPS[1] = reg[1];
+	app_regs.REG_TRIGGERED_MOVE_STEPS[2] = reg[2];
+	app_regs.REG_TRIGGERED_MOVE_STEPS[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_ARM_TRIGGERED_MOVES                                              */
+/************************************************************************/
+void app_read_REG_ARM_TRIGGERED_MOVES(void)
+{
+	app_regs.REG_ARM_TRIGGERED_MOVES = triggered_move_get_armed();
+}
+
+bool app_write_REG_ARM_TRIGGERED_MOVES(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg & 0xF0) return false;
+	
+	if (triggered_move_arm(reg) == false)
+	{
+		return false;
+	}
+
+	app_regs.REG_ARM_TRIGGERED_MOVES = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_ENCODERS_POSITION                                                */
+/************************************************************************/
+void app_read_REG_ENCODERS_POSITION(void)
+{
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (encoders_get_mode(i) == GM_ENCODER_INDEX_RESET)
+			app_regs.REG_ENCODERS_POSITION[i] = encoders_get_index_position(i);
+		else
+			app_regs.REG_ENCODERS_POSITION[i] = encoders_get_position(i);
+	}
+}
+
+bool app_write_REG_ENCODERS_POSITION(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_ENCODERS_VELOCITY                                                */
+/************************************************************************/
+void app_read_REG_ENCODERS_VELOCITY(void)
+{
+	app_regs.REG_ENCODERS_VELOCITY[0] = encoders_get_velocity(0);
+	app_regs.REG_ENCODERS_VELOCITY[1] = encoders_get_velocity(1);
+	app_regs.REG_ENCODERS_VELOCITY[2] = encoders_get_velocity(2);
+}
+
+bool app_write_REG_ENCODERS_VELOCITY(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_ENCODERS_BATCH                                                   */
+/************************************************************************/
+// This register is an array with ENCODERS_BATCH_SAMPLES * ENCODERS_QUANTITY positions
+void app_read_REG_ENCODERS_BATCH(void) {}
+bool app_write_REG_ENCODERS_BATCH(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_MODE                                                   */
+/************************************************************************/
+void app_read_REG_TELEMETRY_MODE(void) {}
+bool app_write_REG_TELEMETRY_MODE(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg > GM_TELEMETRY_FRAME) return false;
+	
+	/* Start with a keyframe */
+	telemetry_restart();
+
+	app_regs.REG_TELEMETRY_MODE = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_RATE                                                   */
+/************************************************************************/
+void app_read_REG_TELEMETRY_RATE(void) {}
+bool app_write_REG_TELEMETRY_RATE(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg > GM_RATE_500HZ) return false;
+
+	app_regs.REG_TELEMETRY_RATE = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_KEYFRAME_INTERVAL                                      */
+/************************************************************************/
+void app_read_REG_TELEMETRY_KEYFRAME_INTERVAL(void) {}
+bool app_write_REG_TELEMETRY_KEYFRAME_INTERVAL(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg == 0) return false;
+
+	app_regs.REG_TELEMETRY_KEYFRAME_INTERVAL = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_KEYFRAME                                               */
+/************************************************************************/
+void app_read_REG_TELEMETRY_KEYFRAME(void) {}
+bool app_write_REG_TELEMETRY_KEYFRAME(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_DELTAS                                                 */
+/************************************************************************/
+void app_read_REG_TELEMETRY_DELTAS(void) {}
+bool app_write_REG_TELEMETRY_DELTAS(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_EVENTS_ON_CHANGE                                                 */
+/************************************************************************/
+void app_read_REG_EVENTS_ON_CHANGE(void) {}
+bool app_write_REG_EVENTS_ON_CHANGE(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg & ~(B_ON_CHANGE_ACCUMULATED_STEPS | B_ON_CHANGE_ENCODERS | B_ON_CHANGE_TELEMETRY)) return false;
+
+	app_regs.REG_EVENTS_ON_CHANGE = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_ACCUMULATED_STEPS_DEADBAND                                       */
+/************************************************************************/
+void app_read_REG_ACCUMULATED_STEPS_DEADBAND(void) {}
+bool app_write_REG_ACCUMULATED_STEPS_DEADBAND(void *a)
+{
+	app_regs.REG_ACCUMULATED_STEPS_DEADBAND = *((uint16_t*)a);
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_ENCODERS_DEADBAND                                                */
+/************************************************************************/
+void app_read_REG_ENCODERS_DEADBAND(void) {}
+bool app_write_REG_ENCODERS_DEADBAND(void *a)
+{
+	app_regs.REG_ENCODERS_DEADBAND = *((uint16_t*)a);
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_EVENTS_HEARTBEAT_INTERVAL                                        */
+/************************************************************************/
+void app_read_REG_EVENTS_HEARTBEAT_INTERVAL(void) {}
+bool app_write_REG_EVENTS_HEARTBEAT_INTERVAL(void *a)
+{
+	app_regs.REG_EVENTS_HEARTBEAT_INTERVAL = *((uint16_t*)a);
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_FRAME_FIELDS                                           */
+/************************************************************************/
+void app_read_REG_TELEMETRY_FRAME_FIELDS(void) {}
+bool app_write_REG_TELEMETRY_FRAME_FIELDS(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg == 0) return false;
+	if (reg & ~(B_FRAME_ACCUMULATED_STEPS | B_FRAME_ENCODERS_POSITION | B_FRAME_ENCODERS_VELOCITY | B_FRAME_MOTORS_STOPPED | B_FRAME_DIGITAL_INPUTS)) return false;
+
+	app_regs.REG_TELEMETRY_FRAME_FIELDS = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_TELEMETRY_FRAME                                                  */
+/************************************************************************/
+// The first element is the mask of the valid fields, the others are always at the same position
+void app_read_REG_TELEMETRY_FRAME(void) {}
+bool app_write_REG_TELEMETRY_FRAME(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_MOTORS_STEPS_PER_COUNT                                           */
+/************************************************************************/
+void app_read_REG_MOTORS_STEPS_PER_COUNT(void) {}
+bool app_write_REG_MOTORS_STEPS_PER_COUNT(void *a)
+{
+	float *reg = ((float*)a);
+	
+	app_regs.REG_MOTORS_STEPS_PER_COUNT[0] = reg[0];
+	app_regs.REG_MOTORS_STEPS_PER_COUNT[1] = reg[1];
+	app_regs.REG_MOTORS_STEPS_PER_COUNT[2] = reg[2];
+	
+	closed_loop_resync(B_MOTOR0 | B_MOTOR1 | B_MOTOR2);
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_FOLLOWING_ERROR_THRESHOLD                                        */
+/************************************************************************/
+void app_read_REG_FOLLOWING_ERROR_THRESHOLD(void) {}
+bool app_write_REG_FOLLOWING_ERROR_THRESHOLD(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	app_regs.REG_FOLLOWING_ERROR_THRESHOLD[0] = reg[0];
+	app_regs.REG_FOLLOWING_ERROR_THRESHOLD[1] = reg[1];
+	app_regs.REG_FOLLOWING_ERROR_THRESHOLD[2] = reg[2];
+	
+	/* The error is measured from the moment the detection is configured */
+	closed_loop_resync(B_MOTOR0 | B_MOTOR1 | B_MOTOR2);
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_FOLLOWING_ERROR_STOP_MOTORS                                      */
+/************************************************************************/
+void app_read_REG_FOLLOWING_ERROR_STOP_MOTORS(void) {}
+bool app_write_REG_FOLLOWING_ERROR_STOP_MOTORS(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg & ~(B_MOTOR0 | B_MOTOR1 | B_MOTOR2)) return false;
+
+	app_regs.REG_FOLLOWING_ERROR_STOP_MOTORS = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_FOLLOWING_ERROR                                                  */
+/************************************************************************/
+void app_read_REG_FOLLOWING_ERROR(void)
+{
+	app_regs.REG_FOLLOWING_ERROR[0] = closed_loop_get_following_error(0);
+	app_regs.REG_FOLLOWING_ERROR[1] = closed_loop_get_following_error(1);
+	app_regs.REG_FOLLOWING_ERROR[2] = closed_loop_get_following_error(2);
+}
+
+bool app_write_REG_FOLLOWING_ERROR(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_FOLLOWING_ERROR_DETECTED                                         */
+/************************************************************************/
+void app_read_REG_FOLLOWING_ERROR_DETECTED(void) {}
+bool app_write_REG_FOLLOWING_ERROR_DETECTED(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg & ~(B_MOTOR0 | B_MOTOR1 | B_MOTOR2)) return false;
+	
+	/* Acknowledges the motors by zeroing their following error */
+	closed_loop_resync(reg);
+
+	app_regs.REG_FOLLOWING_ERROR_DETECTED &= ~reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_POSITION_CORRECTION_TOLERANCE                                    */
+/************************************************************************/
+void app_read_REG_POSITION_CORRECTION_TOLERANCE(void) {}
+bool app_write_REG_POSITION_CORRECTION_TOLERANCE(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	app_regs.REG_POSITION_CORRECTION_TOLERANCE[0] = reg[0];
+	app_regs.REG_POSITION_CORRECTION_TOLERANCE[1] = reg[1];
+	app_regs.REG_POSITION_CORRECTION_TOLERANCE[2] = reg[2];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_POSITION_CORRECTION                                              */
+/************************************************************************/
+void app_read_REG_POSITION_CORRECTION(void) {}
+bool app_write_REG_POSITION_CORRECTION(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_GEARING_CONFIGURATION                                            */
+/************************************************************************/
+void app_read_REG_GEARING_CONFIGURATION(void) {}
+bool app_write_REG_GEARING_CONFIGURATION(void *a)
+{
+	uint8_t *reg = ((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if ((reg[i] & ~(MSK_GEARING_ENCODER | B_GEARING_ENABLE)) || (reg[i] & MSK_GEARING_ENCODER) >= ENCODERS_QUANTITY)
+			return false;
+	}
+	
+	/* A motor that is moving can't be engaged, so the others are still configured */
+	bool success = true;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (!gearing_configure(i, reg[i]))
+			success = false;
+	}
+	
+	return success;
+}
+
+
+/************************************************************************/
+/* REG_GEARING_RATIO                                                    */
+/************************************************************************/
+void app_read_REG_GEARING_RATIO(void) {}
+bool app_write_REG_GEARING_RATIO(void *a)
+{
+	float *reg = ((float*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		app_regs.REG_GEARING_RATIO[i] = reg[i];
+		
+		/* The new ratio applies from the current positions */
+		if (gearing_is_running(i))
+			gearing_restart(i);
+	}
+	
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_GEARING_MAXIMUM_SPEED                                            */
+/************************************************************************/
+void app_read_REG_GEARING_MAXIMUM_SPEED(void) {}
+bool app_write_REG_GEARING_MAXIMUM_SPEED(void *a)
+{
+	float *reg = ((float*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] < GEARING_MINIMUM_SPEED || reg[i] > GEARING_SPEED_LIMIT)
+			return false;
+	}
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+		app_regs.REG_GEARING_MAXIMUM_SPEED[i] = reg[i];
+	
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_GEARING_ACCELERATION                                             */
+/************************************************************************/
+void app_read_REG_GEARING_ACCELERATION(void) {}
+bool app_write_REG_GEARING_ACCELERATION(void *a)
+{
+	float *reg = ((float*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] < 0)
+			return false;
+	}
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+		app_regs.REG_GEARING_ACCELERATION[i] = reg[i];
+	
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_ENCODERS_INDEX_CONFIGURATION                                     */
+/************************************************************************/
+void app_read_REG_ENCODERS_INDEX_CONFIGURATION(void) {}
+bool app_write_REG_ENCODERS_INDEX_CONFIGURATION(void *a)
+{
+	uint8_t *reg = ((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (reg[i] & ~(MSK_ENCODER_INDEX_INPUT | B_ENCODER_INDEX_ON_FALLING)) return false;
+	}
+	
+	app_regs.REG_ENCODERS_INDEX_CONFIGURATION[0] = reg[0];
+	app_regs.REG_ENCODERS_INDEX_CONFIGURATION[1] = reg[1];
+	app_regs.REG_ENCODERS_INDEX_CONFIGURATION[2] = reg[2];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_ENCODERS_CONFIGURATION                                           */
+/************************************************************************/
+void app_read_REG_ENCODERS_CONFIGURATION(void) {}
+bool app_write_REG_ENCODERS_CONFIGURATION(void *a)
+{
+	uint8_t *reg = ((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (reg[i] & ~(MSK_ENCODER_FILTER | B_ENCODER_INVERT_DIRECTION)) return false;
+	}
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		encoders_configure(i, reg[i]);
+		app_regs.REG_ENCODERS_CONFIGURATION[i] = reg[i];
+	}
+	
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL                            */
+/************************************************************************/
+void app_read_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL(void) {}
+bool app_write_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		/* Without ramp, the immediate steps change the interval at once */
+		if (reg[i] == 0)
+			immediate_steps_ramp_cancel(i);
+		
+		app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[i] = reg[i];
+	}
+	
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_IMMEDIATE_STEPS_TIMEOUT                                          */
+/************************************************************************/
+void app_read_REG_IMMEDIATE_STEPS_TIMEOUT(void) {}
+bool app_write_REG_IMMEDIATE_STEPS_TIMEOUT(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[0] = reg[0];
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[1] = reg[1];
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[2] = reg[2];
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED                                  */
+/************************************************************************/
+void app_read_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED(void) {}
+bool app_write_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_FEED_RATE_OVERRIDE                                               */
+/************************************************************************/
+void app_read_REG_FEED_RATE_OVERRIDE(void) {}
+bool app_write_REG_FEED_RATE_OVERRIDE(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	if (reg < FEED_RATE_MINIMUM_PERCENT || reg > FEED_RATE_MAXIMUM_PERCENT) return false;
+	
+	/* The applied override is slewed to the new value every millisecond */
+	app_regs.REG_FEED_RATE_OVERRIDE = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_MOTORS_FEED_RATE_OVERRIDE                                        */
+/************************************************************************/
+void app_read_REG_MOTORS_FEED_RATE_OVERRIDE(void) {}
+bool app_write_REG_MOTORS_FEED_RATE_OVERRIDE(void *a)
+{
+	uint8_t *reg = ((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] < FEED_RATE_MINIMUM_PERCENT || reg[i] > FEED_RATE_MAXIMUM_PERCENT) return false;
+	}
+	
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[0] = reg[0];
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[1] = reg[1];
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[2] = reg[2];
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_PAUSE_MOVES                                                      */
+/************************************************************************/
+void app_read_REG_PAUSE_MOVES(void)
+{
+	app_regs.REG_PAUSE_MOVES = get_paused_motors();
+}
+
+bool app_write_REG_PAUSE_MOVES(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (!(reg & (1 << i)) || homing_is_running(i))
+			continue;
+		
+		pause_rotation(i);
+	}
+	
+	app_regs.REG_PAUSE_MOVES = get_paused_motors();
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_RESUME_MOVES                                                     */
+/************************************************************************/
+void app_read_REG_RESUME_MOVES(void)
+{
+	app_regs.REG_RESUME_MOVES = 0;
+}
+
+bool app_write_REG_RESUME_MOVES(void *a)
+{
+	uint8_t reg = *((uint8_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (!(reg & (1 << i)))
+			continue;
+		
+		/* The drive must be enabled to complete the move */
+		if (i == 0 && read_DRIVE_ENABLE_M0) continue;
+		if (i == 1 && read_DRIVE_ENABLE_M1) continue;
+		if (i == 2 && read_DRIVE_ENABLE_M2) continue;
+		if (i == 3 && read_DRIVE_ENABLE_M3) continue;
+		
+		resume_rotation(i);
+	}
+	
+	app_regs.REG_RESUME_MOVES = reg;
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_BLENDED_MOVE_STEP_INTERVAL                                       */
+/************************************************************************/
+void app_read_REG_BLENDED_MOVE_STEP_INTERVAL(void) {}
+bool app_write_REG_BLENDED_MOVE_STEP_INTERVAL(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] != 0 && (reg[i] < PERIOD_LIMIT || reg[i] > 20000)) return false;
+	}
+	
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[0] = reg[0];
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[1] = reg[1];
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[2] = reg[2];
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_BLENDED_MOVE_STEPS                                               */
+/************************************************************************/
+void app_read_REG_BLENDED_MOVE_STEPS(void) {}
+bool app_write_REG_BLENDED_MOVE_STEPS(void *a)
+{
+	int32_t *reg = ((int32_t*)a);
+	
+	if ((reg[0] != 0) && read_DRIVE_ENABLE_M0) return false;
+	if ((reg[1] != 0) && read_DRIVE_ENABLE_M1) return false;
+	if ((reg[2] != 0) && read_DRIVE_ENABLE_M2) return false;
+	if ((reg[3] != 0) && read_DRIVE_ENABLE_M3) return false;
+	
+	/* Check all the motors first, so the moves are queued on all of them or on none */
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] == 0)
+			continue;
+		
+		if (homing_is_running(i) || gearing_is_running(i) || user_requested_steps[i] != 0) return false;
+		if (blended_move_can_push(i) == false) return false;
+	}
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (reg[i] == 0)
+			continue;
+		
+		uint16_t interval = app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[i];
+		
+		if (interval == 0)
+			interval = *((&app_regs.REG_MOTOR0_NOMINAL_STEP_INTERVAL) + i);
+		
+		blended_move_push(i, reg[i], interval >> 1);
+	}
+	
+	app_regs.REG_BLENDED_MOVE_STEPS[0] = reg[0];
+	app_regs.REG_BLENDED_MOVE_STEPS[1] = reg[1];
+	app_regs.REG_BLENDED_MOVE_STEPS[2] = reg[2];
+	app_regs.REG_BLENDED_MOVE_STEPS[3] = reg[3];
+	return true;
+}
+
+
+/************************************************************************/
+/* REG_BLENDED_MOVES_PENDING                                            */
+/************************************************************************/
+void app_read_REG_BLENDED_MOVES_PENDING(void)
+{
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		app_regs.REG_BLENDED_MOVES_PENDING[i] = blended_move_get_pending(i);
+	}
+}
+
+bool app_write_REG_BLENDED_MOVES_PENDING(void *a)
+{
+	return false;
+}
+
+
+/************************************************************************/
+/* REG_BACKLASH_STEPS                                                   */
+/************************************************************************/
+void app_read_REG_BACKLASH_STEPS(void) {}
+bool app_write_REG_BACKLASH_STEPS(void *a)
+{
+	uint16_t *reg = ((uint16_t*)a);
+	
+	/* Applies from the next direction change */
+	app_regs.REG_BACKLASH_STEPS[0] = reg[0];
+	app_regs.REG_BACKLASH_STEPS[1] = reg[1];
+	app_regs.REG_BACKLASH_STEPS[2] = reg[2];
+	app_regs.REG_BACKLASH_STEPS[3] = reg[3];
+	return true;
+}
+
+/************************************************************************/
+/* REG_TELEMETRY_WIDE_DELTAS                                            */
+/************************************************************************/
+void app_read_REG_TELEMETRY_WIDE_DELTAS(void) {}
+bool app_write_REG_TELEMETRY_WIDE_DELTAS(void *a)
+{
+	return false;
 }
\ No newline at end of file
@@ -129,6 +129,58 @@ void app_read_REG_MOTOR1_QUICK_ACCELERATION(void);
 void app_read_REG_MOTOR2_QUICK_ACCELERATION(void);
 void app_read_REG_MOTOR1_QUICK_DISTANCE(void);
 void app_read_REG_MOTOR2_QUICK_DISTANCE(void);
+void app_read_REG_MOTORS_MAXIMUM_CURRENT_RMS(void);
+void app_read_REG_START_HOMING(void);
+void app_read_REG_HOMING_CONFIGURATION(void);
+void app_read_REG_HOMING_FAST_STEP_INTERVAL(void);
+void app_read_REG_HOMING_SLOW_STEP_INTERVAL(void);
+void app_read_REG_HOMING_BACK_OFF_STEPS(void);
+void app_read_REG_HOMING_MAXIMUM_STEPS(void);
+void app_read_REG_HOMING_DONE(void);
+void app_read_REG_POSITION_LATCH_MODE(void);
+void app_read_REG_LATCHED_POSITIONS(void);
+void app_read_REG_TRIGGERED_MOVE_CONFIGURATION(void);
+void app_read_REG_TRIGGERED_MOVE_STEPS(void);
+void app_read_REG_ARM_TRIGGERED_MOVES(void);
+void app_read_REG_ENCODERS_POSITION(void);
+void app_read_REG_ENCODERS_VELOCITY(void);
+void app_read_REG_ENCODERS_BATCH(void);
+void app_read_REG_TELEMETRY_MODE(void);
+void app_read_REG_TELEMETRY_RATE(void);
+void app_read_REG_TELEMETRY_KEYFRAME_INTERVAL(void);
+void app_read_REG_TELEMETRY_KEYFRAME(void);
+void app_read_REG_TELEMETRY_DELTAS(void);
+void app_read_REG_EVENTS_ON_CHANGE(void);
+void app_read_REG_ACCUMULATED_STEPS_DEADBAND(void);
+void app_read_REG_ENCODERS_DEADBAND(void);
+void app_read_REG_EVENTS_HEARTBEAT_INTERVAL(void);
+void app_read_REG_TELEMETRY_FRAME_FIELDS(void);
+void app_read_REG_TELEMETRY_FRAME(void);
+void app_read_REG_MOTORS_STEPS_PER_COUNT(void);
+void app_read_REG_FOLLOWING_ERROR_THRESHOLD(void);
+void app_read_REG_FOLLOWING_ERROR_STOP_MOTORS(void);
+void app_read_REG_FOLLOWING_ERROR(void);
+void app_read_REG_FOLLOWING_ERROR_DETECTED(void);
+void app_read_REG_POSITION_CORRECTION_TOLERANCE(void);
+void app_read_REG_POSITION_CORRECTION(void);
+void app_read_REG_GEARING_CONFIGURATION(void);
+void app_read_REG_GEARING_RATIO(void);
+void app_read_REG_GEARING_MAXIMUM_SPEED(void);
+void app_read_REG_GEARING_ACCELERATION(void);
+void app_read_REG_ENCODERS_INDEX_CONFIGURATION(void);
+void app_read_REG_ENCODERS_CONFIGURATION(void);
+void app_read_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL(void);
+void app_read_REG_IMMEDIATE_STEPS_TIMEOUT(void);
+void app_read_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED(void);
+void app_read_REG_FEED_RATE_OVERRIDE(void);
+void app_read_REG_MOTORS_FEED_RATE_OVERRIDE(void);
+void app_read_REG_PAUSE_MOVES(void);
+void app_read_REG_RESUME_MOVES(void);
+void app_read_REG_BLENDED_MOVE_STEP_INTERVAL(void);
+void app_read_REG_BLENDED_MOVE_STEPS(void);
+void app_read_REG_BLENDED_MOVES_PENDING(void);
+void app_read_REG_BACKLASH_STEPS(void);
+void app_read_REG_TELEMETRY_WIDE_DELTAS(void);
 
 bool app_write_REG_ENABLE_MOTORS(void *a);
 bool app_write_REG_DISABLE_MOTORS(void *a);
@@ -239,6 +291,58 @@ bool app_write_REG_MOTOR1_QUICK_ACCELERATION(void *a);
 bool app_write_REG_MOTOR2_QUICK_ACCELERATION(void *a);
 bool app_write_REG_MOTOR1_QUICK_DISTANCE(void *a);
 bool app_write_REG_MOTOR2_QUICK_DISTANCE(void *a);
+bool app_write_REG_MOTORS_MAXIMUM_CURRENT_RMS(void *a);
+bool app_write_REG_START_HOMING(void *a);
+bool app_write_REG_HOMING_CONFIGURATION(void *a);
+bool app_write_REG_HOMING_FAST_STEP_INTERVAL(void *a);
+bool app_write_REG_HOMING_SLOW_STEP_INTERVAL(void *a);
+bool app_write_REG_HOMING_BACK_OFF_STEPS(void *a);
+bool app_write_REG_HOMING_MAXIMUM_STEPS(void *a);
+bool app_write_REG_HOMING_DONE(void *a);
+bool app_write_REG_POSITION_LATCH_MODE(void *a);
+bool app_write_REG_LATCHED_POSITIONS(void *a);
+bool app_write_REG_TRIGGERED_MOVE_CONFIGURATION(void *a);
+bool app_write_REG_TRIGGERED_MOVE_STEPS(void *a);
+bool app_write_REG_ARM_TRIGGERED_MOVES(void *a);
+bool app_write_REG_ENCODERS_POSITION(void *a);
+bool app_write_REG_ENCODERS_VELOCITY(void *a);
+bool app_write_REG_ENCODERS_BATCH(void *a);
+bool app_write_REG_TELEMETRY_MODE(void *a);
+bool app_write_REG_TELEMETRY_RATE(void *a);
+bool app_write_REG_TELEMETRY_KEYFRAME_INTERVAL(void *a);
+bool app_write_REG_TELEMETRY_KEYFRAME(void *a);
+bool app_write_REG_TELEMETRY_DELTAS(void *a);
+bool app_write_REG_EVENTS_ON_CHANGE(void *a);
+bool app_write_REG_ACCUMULATED_STEPS_DEADBAND(void *a);
+bool app_write_REG_ENCODERS_DEADBAND(void *a);
+bool app_write_REG_EVENTS_HEARTBEAT_INTERVAL(void *a);
+bool app_write_REG_TELEMETRY_FRAME_FIELDS(void *a);
+bool app_write_REG_TELEMETRY_FRAME(void *a);
+bool app_write_REG_MOTORS_STEPS_PER_COUNT(void *a);
+bool app_write_REG_FOLLOWING_ERROR_THRESHOLD(void *a);
+bool app_write_REG_FOLLOWING_ERROR_STOP_MOTORS(void *a);
+bool app_write_REG_FOLLOWING_ERROR(void *a);
+bool app_write_REG_FOLLOWING_ERROR_DETECTED(void *a);
+bool app_write_REG_POSITION_CORRECTION_TOLERANCE(void *a);
+bool app_write_REG_POSITION_CORRECTION(void *a);
+bool app_write_REG_GEARING_CONFIGURATION(void *a);
+bool app_write_REG_GEARING_RATIO(void *a);
+bool app_write_REG_GEARING_MAXIMUM_SPEED(void *a);
+bool app_write_REG_GEARING_ACCELERATION(void *a);
+bool app_write_REG_ENCODERS_INDEX_CONFIGURATION(void *a);
+bool app_write_REG_ENCODERS_CONFIGURATION(void *a);
+bool app_write_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL(void *a);
+bool app_write_REG_IMMEDIATE_STEPS_TIMEOUT(void *a);
+bool app_write_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED(void *a);
+bool app_write_REG_FEED_RATE_OVERRIDE(void *a);
+bool app_write_REG_MOTORS_FEED_RATE_OVERRIDE(void *a);
+bool app_write_REG_PAUSE_MOVES(void *a);
+bool app_write_REG_RESUME_MOVES(void *a);
+bool app_write_REG_BLENDED_MOVE_STEP_INTERVAL(void *a);
+bool app_write_REG_BLENDED_MOVE_STEPS(void *a);
+bool app_write_REG_BLENDED_MOVES_PENDING(void *a);
+bool app_write_REG_BACKLASH_STEPS(void *a);
+bool app_write_REG_TELEMETRY_WIDE_DELTAS(void *a);
 
 
 #endif /* _APP_FUNCTIONS_H_ */
\ No newline at end of file
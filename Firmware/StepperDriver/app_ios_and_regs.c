@@ -245,7 +245,59 @@ uint8_t app_regs_type[] = {
 	TYPE_FLOAT,
 	TYPE_FLOAT,
 	TYPE_FLOAT,
-	TYPE_FLOAT
+	TYPE_FLOAT,
+	TYPE_FLOAT,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U16,
+	TYPE_U16,
+	TYPE_U16,
+	TYPE_U32,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_I32,
+	TYPE_U8,
+	TYPE_I32,
+	TYPE_U8,
+	TYPE_I32,
+	TYPE_FLOAT,
+	TYPE_I16,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_I32,
+	TYPE_I8,
+	TYPE_U8,
+	TYPE_U16,
+	TYPE_U16,
+	TYPE_U16,
+	TYPE_U8,
+	TYPE_I32,
+	TYPE_FLOAT,
+	TYPE_U16,
+	TYPE_U8,
+	TYPE_I32,
+	TYPE_U8,
+	TYPE_U16,
+	TYPE_I32,
+	TYPE_U8,
+	TYPE_FLOAT,
+	TYPE_FLOAT,
+	TYPE_FLOAT,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U16,
+	TYPE_U16,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U8,
+	TYPE_U16,
+	TYPE_I32,
+	TYPE_U8,
+	TYPE_U16,
+	TYPE_I16
 };
 
 uint16_t app_regs_n_elements[] = {
@@ -357,7 +409,59 @@ uint16_t app_regs_n_elements[] = {
 	1,
 	1,
 	1,
-	1
+	1,
+	4,
+	1,
+	4,
+	4,
+	4,
+	4,
+	4,
+	1,
+	1,
+	8,
+	4,
+	4,
+	1,
+	3,
+	3,
+	24,
+	1,
+	1,
+	1,
+	7,
+	7,
+	1,
+	1,
+	1,
+	1,
+	1,
+	13,
+	3,
+	3,
+	1,
+	3,
+	1,
+	3,
+	3,
+	4,
+	4,
+	4,
+	4,
+	3,
+	3,
+	4,
+	4,
+	1,
+	1,
+	4,
+	1,
+	1,
+	4,
+	4,
+	4,
+	4,
+	7
 };
 
 uint8_t *app_regs_pointer[] = {
@@ -469,5 +573,57 @@ uint8_t *app_regs_pointer[] = {
 	(uint8_t*)(&app_regs.REG_MOTOR1_QUICK_ACCELERATION),
 	(uint8_t*)(&app_regs.REG_MOTOR2_QUICK_ACCELERATION),
 	(uint8_t*)(&app_regs.REG_MOTOR1_QUICK_DISTANCE),
-	(uint8_t*)(&app_regs.REG_MOTOR2_QUICK_DISTANCE)
+	(uint8_t*)(&app_regs.REG_MOTOR2_QUICK_DISTANCE),
+	(uint8_t*)(app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS),
+	(uint8_t*)(&app_regs.REG_START_HOMING),
+	(uint8_t*)(app_regs.REG_HOMING_CONFIGURATION),
+	(uint8_t*)(app_regs.REG_HOMING_FAST_STEP_INTERVAL),
+	(uint8_t*)(app_regs.REG_HOMING_SLOW_STEP_INTERVAL),
+	(uint8_t*)(app_regs.REG_HOMING_BACK_OFF_STEPS),
+	(uint8_t*)(app_regs.REG_HOMING_MAXIMUM_STEPS),
+	(uint8_t*)(&app_regs.REG_HOMING_DONE),
+	(uint8_t*)(&app_regs.REG_POSITION_LATCH_MODE),
+	(uint8_t*)(app_regs.REG_LATCHED_POSITIONS),
+	(uint8_t*)(app_regs.REG_TRIGGERED_MOVE_CONFIGURATION),
+	(uint8_t*)(app_regs.REG_TRIGGERED_MOVE_STEPS),
+	(uint8_t*)(&app_regs.REG_ARM_TRIGGERED_MOVES),
+	(uint8_t*)(app_regs.REG_ENCODERS_POSITION),
+	(uint8_t*)(app_regs.REG_ENCODERS_VELOCITY),
+	(uint8_t*)(app_regs.REG_ENCODERS_BATCH),
+	(uint8_t*)(&app_regs.REG_TELEMETRY_MODE),
+	(uint8_t*)(&app_regs.REG_TELEMETRY_RATE),
+	(uint8_t*)(&app_regs.REG_TELEMETRY_KEYFRAME_INTERVAL),
+	(uint8_t*)(app_regs.REG_TELEMETRY_KEYFRAME),
+	(uint8_t*)(app_regs.REG_TELEMETRY_DELTAS),
+	(uint8_t*)(&app_regs.REG_EVENTS_ON_CHANGE),
+	(uint8_t*)(&app_regs.REG_ACCUMULATED_STEPS_DEADBAND),
+	(uint8_t*)(&app_regs.REG_ENCODERS_DEADBAND),
+	(uint8_t*)(&app_regs.REG_EVENTS_HEARTBEAT_INTERVAL),
+	(uint8_t*)(&app_regs.REG_TELEMETRY_FRAME_FIELDS),
+	(uint8_t*)(app_regs.REG_TELEMETRY_FRAME),
+	(uint8_t*)(app_regs.REG_MOTORS_STEPS_PER_COUNT),
+	(uint8_t*)(app_regs.REG_FOLLOWING_ERROR_THRESHOLD),
+	(uint8_t*)(&app_regs.REG_FOLLOWING_ERROR_STOP_MOTORS),
+	(uint8_t*)(app_regs.REG_FOLLOWING_ERROR),
+	(uint8_t*)(&app_regs.REG_FOLLOWING_ERROR_DETECTED),
+	(uint8_t*)(app_regs.REG_POSITION_CORRECTION_TOLERANCE),
+	(uint8_t*)(app_regs.REG_POSITION_CORRECTION),
+	(uint8_t*)(app_regs.REG_GEARING_CONFIGURATION),
+	(uint8_t*)(app_regs.REG_GEARING_RATIO),
+	(uint8_t*)(app_regs.REG_GEARING_MAXIMUM_SPEED),
+	(uint8_t*)(app_regs.REG_GEARING_ACCELERATION),
+	(uint8_t*)(app_regs.REG_ENCODERS_INDEX_CONFIGURATION),
+	(uint8_t*)(app_regs.REG_ENCODERS_CONFIGURATION),
+	(uint8_t*)(app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL),
+	(uint8_t*)(app_regs.REG_IMMEDIATE_STEPS_TIMEOUT),
+	(uint8_t*)(&app_regs.REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED),
+	(uint8_t*)(&app_regs.REG_FEED_RATE_OVERRIDE),
+	(uint8_t*)(app_regs.REG_MOTORS_FEED_RATE_OVERRIDE),
+	(uint8_t*)(&app_regs.REG_PAUSE_MOVES),
+	(uint8_t*)(&app_regs.REG_RESUME_MOVES),
+	(uint8_t*)(app_regs.REG_BLENDED_MOVE_STEP_INTERVAL),
+	(uint8_t*)(app_regs.REG_BLENDED_MOVE_STEPS),
+	(uint8_t*)(app_regs.REG_BLENDED_MOVES_PENDING),
+	(uint8_t*)(app_regs.REG_BACKLASH_STEPS),
+	(uint8_t*)(app_regs.REG_TELEMETRY_WIDE_DELTAS)
 };
\ No newline at end of file
@@ -479,6 +479,58 @@ typedef struct
 	float REG_MOTOR2_QUICK_ACCELERATION;
 	float REG_MOTOR1_QUICK_DISTANCE;
 	float REG_MOTOR2_QUICK_DISTANCE;
+	float REG_MOTORS_MAXIMUM_CURRENT_RMS[4];
+	uint8_t REG_START_HOMING;
+	uint8_t REG_HOMING_CONFIGURATION[4];
+	uint16_t REG_HOMING_FAST_STEP_INTERVAL[4];
+	uint16_t REG_HOMING_SLOW_STEP_INTERVAL[4];
+	uint16_t REG_HOMING_BACK_OFF_STEPS[4];
+	uint32_t REG_HOMING_MAXIMUM_STEPS[4];
+	uint8_t REG_HOMING_DONE;
+	uint8_t REG_POSITION_LATCH_MODE;
+	int32_t REG_LATCHED_POSITIONS[8];
+	uint8_t REG_TRIGGERED_MOVE_CONFIGURATION[4];
+	int32_t REG_TRIGGERED_MOVE_STEPS[4];
+	uint8_t REG_ARM_TRIGGERED_MOVES;
+	int32_t REG_ENCODERS_POSITION[3];
+	float REG_ENCODERS_VELOCITY[3];
+	int16_t REG_ENCODERS_BATCH[24];
+	uint8_t REG_TELEMETRY_MODE;
+	uint8_t REG_TELEMETRY_RATE;
+	uint8_t REG_TELEMETRY_KEYFRAME_INTERVAL;
+	int32_t REG_TELEMETRY_KEYFRAME[7];
+	int8_t REG_TELEMETRY_DELTAS[7];
+	uint8_t REG_EVENTS_ON_CHANGE;
+	uint16_t REG_ACCUMULATED_STEPS_DEADBAND;
+	uint16_t REG_ENCODERS_DEADBAND;
+	uint16_t REG_EVENTS_HEARTBEAT_INTERVAL;
+	uint8_t REG_TELEMETRY_FRAME_FIELDS;
+	int32_t REG_TELEMETRY_FRAME[13];
+	float REG_MOTORS_STEPS_PER_COUNT[3];
+	uint16_t REG_FOLLOWING_ERROR_THRESHOLD[3];
+	uint8_t REG_FOLLOWING_ERROR_STOP_MOTORS;
+	int32_t REG_FOLLOWING_ERROR[3];
+	uint8_t REG_FOLLOWING_ERROR_DETECTED;
+	uint16_t REG_POSITION_CORRECTION_TOLERANCE[3];
+	int32_t REG_POSITION_CORRECTION[3];
+	uint8_t REG_GEARING_CONFIGURATION[4];
+	float REG_GEARING_RATIO[4];
+	float REG_GEARING_MAXIMUM_SPEED[4];
+	float REG_GEARING_ACCELERATION[4];
+	uint8_t REG_ENCODERS_INDEX_CONFIGURATION[3];
+	uint8_t REG_ENCODERS_CONFIGURATION[3];
+	uint16_t REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[4];
+	uint16_t REG_IMMEDIATE_STEPS_TIMEOUT[4];
+	uint8_t REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED;
+	uint8_t REG_FEED_RATE_OVERRIDE;
+	uint8_t REG_MOTORS_FEED_RATE_OVERRIDE[4];
+	uint8_t REG_PAUSE_MOVES;
+	uint8_t REG_RESUME_MOVES;
+	uint16_t REG_BLENDED_MOVE_STEP_INTERVAL[4];
+	int32_t REG_BLENDED_MOVE_STEPS[4];
+	uint8_t REG_BLENDED_MOVES_PENDING[4];
+	uint16_t REG_BACKLASH_STEPS[4];
+	int16_t REG_TELEMETRY_WIDE_DELTAS[7];
 } AppRegs;
 
 /************************************************************************/
@@ -594,6 +646,58 @@ typedef struct
 #define ADD_REG_MOTOR2_QUICK_ACCELERATION  138 // FLOAT  Configures the motor's acceleration in m/s2 for motor 2.
 #define ADD_REG_MOTOR1_QUICK_DISTANCE      139 // FLOAT  Configures the motor's travel distance in mm for motor 1.
 #define ADD_REG_MOTOR2_QUICK_DISTANCE      140 // FLOAT  Configures the motor's travel distance in mm for motor 2.
+#define ADD_REG_MOTORS_MAXIMUM_CURRENT_RMS 141 // FLOAT  Configures the maximum RMS current per phase of all motors, updating each digital potentiometer in a single I2C transaction.
+#define ADD_REG_START_HOMING               142 // U8     Starts the homing sequence of the selected motors.
+#define ADD_REG_HOMING_CONFIGURATION       143 // U8     Configures the home switch input, edge and seek direction of each motor.
+#define ADD_REG_HOMING_FAST_STEP_INTERVAL  144 // U16    Configures the step interval used to seek the home switch.
+#define ADD_REG_HOMING_SLOW_STEP_INTERVAL  145 // U16    Configures the step interval used to back off and re-approach the home switch.
+#define ADD_REG_HOMING_BACK_OFF_STEPS      146 // U16    Configures the number of steps to move away from the home switch before re-approaching it.
+#define ADD_REG_HOMING_MAXIMUM_STEPS       147 // U32    Configures the maximum number of steps used to seek the home switch. Zero uses 1000000 steps.
+#define ADD_REG_HOMING_DONE                148 // U8     Event sent when the homing of the requested motors ends.
+#define ADD_REG_POSITION_LATCH_MODE        149 // U8     Configures the digital input edges that latch the position of all motors and encoders.
+#define ADD_REG_LATCHED_POSITIONS          150 // I32    Contains the accumulated steps of all motors and the encoders' counts latched at the input edge.
+#define ADD_REG_TRIGGERED_MOVE_CONFIGURATION 151 // U8     Configures the move launched by each digital input.
+#define ADD_REG_TRIGGERED_MOVE_STEPS       152 // I32    Contains the preloaded steps or position of each motor used by the triggered moves.
+#define ADD_REG_ARM_TRIGGERED_MOVES        153 // U8     Arms the triggered moves of the selected digital inputs.
+#define ADD_REG_ENCODERS_POSITION          154 // I32    Contains the quadrature encoders' positions extended to 32 bits.
+#define ADD_REG_ENCODERS_VELOCITY          155 // FLOAT  Contains the quadrature encoders' filtered velocities in counts per second.
+#define ADD_REG_ENCODERS_BATCH             156 // I16    Contains a batch of quadrature encoders' samples as the first readings followed by differences.
+#define ADD_REG_TELEMETRY_MODE             157 // U8     Configures the compact telemetry.
+#define ADD_REG_TELEMETRY_RATE             158 // U8     Configures the rate of the compact telemetry frames.
+#define ADD_REG_TELEMETRY_KEYFRAME_INTERVAL 159 // U8     Configures the number of delta frames between keyframes.
+#define ADD_REG_TELEMETRY_KEYFRAME         160 // I32    Contains the full accumulated steps and encoders' positions.
+#define ADD_REG_TELEMETRY_DELTAS           161 // I8     Contains the accumulated steps and encoders' positions differences since the last frame.
+#define ADD_REG_EVENTS_ON_CHANGE           162 // U8     Selects the periodic events sent only when their values change.
+#define ADD_REG_ACCUMULATED_STEPS_DEADBAND 163 // U16    Configures the steps change needed to send the accumulated steps.
+#define ADD_REG_ENCODERS_DEADBAND          164 // U16    Configures the counts change needed to send the encoders.
+#define ADD_REG_EVENTS_HEARTBEAT_INTERVAL  165 // U16    Configures the maximum interval, in ms, between on-change events.
+#define ADD_REG_TELEMETRY_FRAME_FIELDS     166 // U8     Selects the fields packed in the combined telemetry frame.
+#define ADD_REG_TELEMETRY_FRAME            167 // I32    Contains the valid fields followed by all the fields sampled at the same instant.
+#define ADD_REG_MOTORS_STEPS_PER_COUNT     168 // FLOAT  Motor steps per encoder count of motors 0 to 2
+#define ADD_REG_FOLLOWING_ERROR_THRESHOLD  169 // U16    Maximum following error, in steps, of motors 0 to 2 (0 disables)
+#define ADD_REG_FOLLOWING_ERROR_STOP_MOTORS 170 // U8     Motors stopped when their following error is exceeded
+#define ADD_REG_FOLLOWING_ERROR            171 // I32    Following error, in steps, of motors 0 to 2
+#define ADD_REG_FOLLOWING_ERROR_DETECTED   172 // U8     Event with the motors exceeding the following error, write to acknowledge
+#define ADD_REG_POSITION_CORRECTION_TOLERANCE 173 // U16    Position tolerance, in steps, at the end of the moves of motors 0 to 2 (0 disables)
+#define ADD_REG_POSITION_CORRECTION        174 // I32    Event with the steps added to the last move of motors 0 to 2 to reach its target
+#define ADD_REG_GEARING_CONFIGURATION      175 // U8     Configures the encoder followed by each motor
+#define ADD_REG_GEARING_RATIO              176 // FLOAT  Motor steps per encoder count of each geared motor
+#define ADD_REG_GEARING_MAXIMUM_SPEED      177 // FLOAT  Maximum speed, in steps/s, of each geared motor
+#define ADD_REG_GEARING_ACCELERATION       178 // FLOAT  Maximum acceleration, in steps/s2, of each geared motor (0 disables)
+#define ADD_REG_ENCODERS_INDEX_CONFIGURATION 179 // U8     Configures the digital input that resets each encoder in index mode
+#define ADD_REG_ENCODERS_CONFIGURATION     180 // U8     Configures the digital filter and direction of each encoder
+#define ADD_REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL 181 // U16    Step interval change, in us, per step of the ramped immediate steps (0 disables the ramp)
+#define ADD_REG_IMMEDIATE_STEPS_TIMEOUT    182 // U16    Time, in ms, without immediate steps updates until the motor stops (0 disables)
+#define ADD_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED 183 // U8     Event with the motors stopped by the immediate steps timeout
+#define ADD_REG_FEED_RATE_OVERRIDE         184 // U8     Speed override, in %, applied to the moves of all the motors
+#define ADD_REG_MOTORS_FEED_RATE_OVERRIDE  185 // U8     Speed override, in %, applied to the moves of each motor
+#define ADD_REG_PAUSE_MOVES                186 // U8     Pauses the moves of the motors, reads the paused motors
+#define ADD_REG_RESUME_MOVES               187 // U8     Resumes the paused moves of the motors
+#define ADD_REG_BLENDED_MOVE_STEP_INTERVAL 188 // U16    Nominal step interval of the next blended moves
+#define ADD_REG_BLENDED_MOVE_STEPS         189 // I32    Queues a blended move on each motor with steps different from 0
+#define ADD_REG_BLENDED_MOVES_PENDING      190 // U8     Blended moves not yet completed on each motor
+#define ADD_REG_BACKLASH_STEPS             191 // U16    Steps added at each direction change of the motors
+#define ADD_REG_TELEMETRY_WIDE_DELTAS      192 // I16    Contains the accumulated steps and encoders' positions differences that don't fit in 8 bits.
 
 /************************************************************************/
 /* PWM Generator registers' memory limits                               */
@@ -603,8 +707,8 @@ typedef struct
 /************************************************************************/
 /* Memory limits */
 #define APP_REGS_ADD_MIN                    0x20
-#define APP_REGS_ADD_MAX                    0x8C
-#define APP_NBYTES_OF_REG_BANK              338
+#define APP_REGS_ADD_MAX                    0xC0
+#define APP_NBYTES_OF_REG_BANK              806
 
 /************************************************************************/
 /* Registers' bits                                                      */
@@ -620,6 +724,41 @@ typedef struct
 #define B_INPUT1                           (1<<1)       // Index of input 1
 #define B_INPUT2                           (1<<2)       // Index of input 2
 #define B_INPUT3                           (1<<3)       // Index of input 3
+#define MSK_HOMING_INPUT                   0x03         // Selects the digital input used as home switch
+#define B_HOMING_POSITIVE_DIRECTION        (1<<4)       // Seeks the home switch moving in the positive direction
+#define B_HOMING_ON_FALLING                (1<<5)       // The home switch is active after a falling edge of the input
+#define B_LATCH_INPUT0_ON_RISING           (1<<0)       // Latches the positions on the rising edge of input 0
+#define B_LATCH_INPUT1_ON_RISING           (1<<1)       // Latches the positions on the rising edge of input 1
+#define B_LATCH_INPUT2_ON_RISING           (1<<2)       // Latches the positions on the rising edge of input 2
+#define B_LATCH_INPUT3_ON_RISING           (1<<3)       // Latches the positions on the rising edge of input 3
+#define B_LATCH_INPUT0_ON_FALLING          (1<<4)       // Latches the positions on the falling edge of input 0
+#define B_LATCH_INPUT1_ON_FALLING          (1<<5)       // Latches the positions on the falling edge of input 1
+#define B_LATCH_INPUT2_ON_FALLING          (1<<6)       // Latches the positions on the falling edge of input 2
+#define B_LATCH_INPUT3_ON_FALLING          (1<<7)       // Latches the positions on the falling edge of input 3
+#define MSK_TRIGGERED_MOVE_MOTORS          0x0F         // Selects the motors launched by the input
+#define MSK_TRIGGERED_MOVE_TYPE            (3<<4)       // Selects the type of the triggered move
+#define B_TRIGGERED_MOVE_ON_FALLING        (1<<6)       // Launches the move on the falling edge of the input instead of the rising edge
+#define MSK_INPUT_STOP_MOTORS              0x0F         // Selects the motors stopped by the input, when B_INPUT_STOP_MOTORS_MASK is set
+#define MSK_INPUT_STOP_MOTOR_INDEX         0x03         // Selects the motor stopped by the input, when B_INPUT_STOP_MOTORS_MASK is not set
+#define B_INPUT_STOP_ON_RISING             (1<<4)       // Stops the selected motors on the rising edge of the input
+#define B_INPUT_STOP_ON_FALLING            (1<<5)       // Stops the selected motors on the falling edge of the input
+#define B_INPUT_STOP_DECELERATING          (1<<6)       // Decelerates the selected motors until stop instead of stopping them immediately
+#define B_INPUT_STOP_MOTORS_MASK           (1<<7)       // The lower nibble is a mask of motors instead of the GM_STOP_MOTORn_ON_* motor index
+#define B_ON_CHANGE_ACCUMULATED_STEPS      (1<<0)       // Sends the accumulated steps only when they change
+#define B_ON_CHANGE_ENCODERS               (1<<1)       // Sends the encoders only when they change
+#define B_ON_CHANGE_TELEMETRY              (1<<2)       // Sends the compact telemetry only when it changes
+#define B_FRAME_ACCUMULATED_STEPS          (1<<0)       // Adds the accumulated steps of the 4 motors to the telemetry frame
+#define B_FRAME_ENCODERS_POSITION          (1<<1)       // Adds the positions of the 3 encoders to the telemetry frame
+#define B_FRAME_ENCODERS_VELOCITY          (1<<2)       // Adds the velocities of the 3 encoders to the telemetry frame
+#define B_FRAME_MOTORS_STOPPED             (1<<3)       // Adds the stopped motors to the telemetry frame
+#define B_FRAME_DIGITAL_INPUTS             (1<<4)       // Adds the digital inputs' state to the telemetry frame
+#define MSK_GEARING_ENCODER                0x03         // Selects the encoder followed by the motor
+#define B_GEARING_ENABLE                   (1<<7)       // The motor follows the selected encoder
+#define MSK_ENCODER_MODE                   0x03         // Selects the mode of an encoder, shifted by 2 bits for each encoder index
+#define MSK_ENCODER_INDEX_INPUT            0x03         // Selects the digital input used as index pulse
+#define B_ENCODER_INDEX_ON_FALLING         (1<<4)       // The index pulse is the falling edge of the input instead of the rising edge
+#define MSK_ENCODER_FILTER                 0x07         // Selects the number of samples of the encoder's digital filter
+#define B_ENCODER_INVERT_DIRECTION         (1<<4)       // Inverts the counting direction of the encoder
 #define GM_QUIET_MODE                      0x00         // Specifies the motor operation mode to QuietMode
 #define GM_DYNAMIC_MOVEMENTS               0x01         // Specifies the motor operation mode to DynamicMovements
 #define GM_MICROSTEPS_8                    0x00         // Specifies the inputs operation mode to 8 microsteps
@@ -630,12 +769,24 @@ typedef struct
 #define GM_REDUCTION_TO_25PCT              0x01         // Hold current reduction to 25 %
 #define GM_REDUCTION_TO_12PCT              0x02         // Hold current reduction to 12.5 %
 #define GM_NO_REDUCTION                    0x03         // No hold current reduction.
-#define GM_POSITION                        0x00         // Specifies the quadrature encoders reading to be Position
-#define GM_DISPLACEMENT                    0x01         // Specifies the quadrature encoders reading to be Displacement
+#define GM_ENCODER_RAW                     0x00         // Specifies the quadrature encoder reading to be the 16-bit counter
+#define GM_ENCODER_EXTENDED                0x01         // Specifies the quadrature encoder reading to be the 32-bit position
+#define GM_ENCODER_VELOCITY                0x02         // Specifies the quadrature encoder reading to be the velocity
+#define GM_ENCODER_INDEX_RESET             0x03         // Specifies the quadrature encoder reading to be the 32-bit position since the last index pulse
+#define GM_ENCODER_FILTER_1SAMPLE          0x00         // The encoder's inputs are filtered during 1 sample
+#define GM_ENCODER_FILTER_2SAMPLES         0x01         // The encoder's inputs are filtered during 2 samples
+#define GM_ENCODER_FILTER_3SAMPLES         0x02         // The encoder's inputs are filtered during 3 samples
+#define GM_ENCODER_FILTER_4SAMPLES         0x03         // The encoder's inputs are filtered during 4 samples
+#define GM_ENCODER_FILTER_5SAMPLES         0x04         // The encoder's inputs are filtered during 5 samples
+#define GM_ENCODER_FILTER_6SAMPLES         0x05         // The encoder's inputs are filtered during 6 samples
+#define GM_ENCODER_FILTER_7SAMPLES         0x06         // The encoder's inputs are filtered during 7 samples
+#define GM_ENCODER_FILTER_8SAMPLES         0x07         // The encoder's inputs are filtered during 8 samples
 #define GM_RATE_100HZ                      0x00         // Specifies the quadrature encoders update rate to 100 Hz
 #define GM_RATE_200HZ                      0x01         // Specifies the quadrature encoders update rate to 200 Hz
 #define GM_RATE_250HZ                      0x02         // Specifies the quadrature encoders update rate to 250 Hz
 #define GM_RATE_500HZ                      0x03         // Specifies the quadrature encoders update rate to 500 Hz
+#define GM_RATE_1KHZ                       0x04         // Specifies the quadrature encoders update rate to 1 kHz sent in batches
+#define GM_RATE_2KHZ                       0x05         // Specifies the quadrature encoders update rate to 2 kHz sent in batches
 #define GM_EVENT_ONLY                      0x00         // Specifies the inputs operation mode to send event only
 #define GM_STOP_MOTOR0_ON_RISING           0x10         // Specifies the inputs operation mode to stop motor 0 on digital rasing
 #define GM_STOP_MOTOR1_ON_RISING           0x11         // Specifies the inputs operation mode to stop motor 1 on digital rasing
@@ -653,5 +804,12 @@ typedef struct
 #define GM_AS_RATE_100HZ                   0x03         // Specifies the accumulated steps update rate to 100 Hz
 #define GM_DISABLED                        0x00         // 
 #define GM_ENABLED                         0x01         // 
+#define GM_TRIGGERED_MOVE_DISABLED         (0<<4)       // The input doesn't launch moves
+#define GM_TRIGGERED_MOVE_RELATIVE         (1<<4)       // Moves the preloaded steps
+#define GM_TRIGGERED_MOVE_ABSOLUTE         (2<<4)       // Moves to the preloaded position
+#define GM_TRIGGERED_MOVE_QUICK            (3<<4)       // Launches the configured quick movement
+#define GM_TELEMETRY_DISABLED              0x00         // The compact telemetry is not sent
+#define GM_TELEMETRY_DELTA                 0x01         // Sends the differences with periodic keyframes
+#define GM_TELEMETRY_FRAME                 0x02         // Sends the selected fields in a single combined frame
 
 #endif /* _APP_REGS_H_ */
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "blended_move.h"
+#include "stepper_control.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+extern PORT_t* motor_peripherals_dir_port[MOTORS_QUANTITY];
+extern const uint8_t motor_peripherals_dir_pin_index[MOTORS_QUANTITY];
+
+extern uint16_t m_max_pulse_interval_us[MOTORS_QUANTITY];
+extern uint16_t m_pulse_step_interval_us[MOTORS_QUANTITY];
+
+extern uint32_t steps_target[MOTORS_QUANTITY];
+extern uint32_t steps_count[MOTORS_QUANTITY];
+extern bool moving_positive[MOTORS_QUANTITY];
+
+extern uint8_t m1_quick_count_down;
+extern uint8_t m2_quick_count_down;
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+// Queued moves, the exit interval is the interval planned at the junction with the following move
+int32_t blended_move_queue_steps[MOTORS_QUANTITY][BLENDED_MOVE_QUEUE_SIZE];
+uint16_t blended_move_queue_nominal[MOTORS_QUANTITY][BLENDED_MOVE_QUEUE_SIZE];
+uint16_t blended_move_queue_exit[MOTORS_QUANTITY][BLENDED_MOVE_QUEUE_SIZE];
+uint8_t blended_move_queue_head[MOTORS_QUANTITY];
+uint8_t blended_move_queue_count[MOTORS_QUANTITY];
+
+// Running move, used by the step interrupt instead of the motor's nominal and maximum intervals
+uint8_t blended_move_running_mask = 0;
+uint16_t blended_move_nominal_interval[MOTORS_QUANTITY];
+uint16_t blended_move_exit_interval[MOTORS_QUANTITY];
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+static uint8_t blended_move_queue_index (uint8_t motor_index, uint8_t position)
+{
+	return (blended_move_queue_head[motor_index] + position) % BLENDED_MOVE_QUEUE_SIZE;
+}
+
+static void blended_move_plan (uint8_t motor_index)
+{
+	uint16_t max_interval = m_max_pulse_interval_us[motor_index];
+	uint16_t step_interval = m_pulse_step_interval_us[motor_index];
+	
+	/* The last move always ends at the maximum interval, so the motor can stop */
+	uint16_t entry_interval = max_interval;
+	
+	/* Backward pass: each junction can't be faster than both moves, nor than what the following move can decelerate from */
+	for (int8_t k = blended_move_queue_count[motor_index] - 1; k >= 0; k--)
+	{
+		uint8_t index = blended_move_queue_index(motor_index, k);
+		int32_t steps = blended_move_queue_steps[motor_index][index];
+		uint16_t nominal = blended_move_queue_nominal[motor_index][index];
+		
+		blended_move_queue_exit[motor_index][index] = entry_interval;
+		
+		int32_t previous_steps;
+		uint16_t previous_nominal;
+		
+		if (k == 0)
+		{
+			previous_steps = moving_positive[motor_index] ? 1 : -1;
+			previous_nominal = blended_move_nominal_interval[motor_index];
+		}
+		else
+		{
+			uint8_t previous_index = blended_move_queue_index(motor_index, k - 1);
+			previous_steps = blended_move_queue_steps[motor_index][previous_index];
+			previous_nominal = blended_move_queue_nominal[motor_index][previous_index];
+		}
+		
+		if ((previous_steps > 0) != (steps > 0))
+		{
+			/* Reversals go through the maximum interval */
+			entry_interval = max_interval;
+		}
+		else
+		{
+			uint32_t deceleration = (uint32_t)((steps < 0) ? -steps : steps) * step_interval;
+			
+			entry_interval = (previous_nominal > nominal) ? previous_nominal : nominal;
+			
+			if (blended_move_queue_exit[motor_index][index] > deceleration &&
+				blended_move_queue_exit[motor_index][index] - deceleration > entry_interval)
+			{
+				entry_interval = blended_move_queue_exit[motor_index][index] - deceleration;
+			}
+		}
+	}
+	
+	blended_move_exit_interval[motor_index] = entry_interval;
+}
+
+
+/************************************************************************/
+/* Blended move routines                                                */
+/************************************************************************/
+bool blended_move_push (uint8_t motor_index, int32_t steps, uint16_t nominal_interval)
+{
+	TC0_t* timer = motor_peripherals_timer[motor_index];
+	
+	if (steps == 0 || !blended_move_can_push(motor_index))
+	{
+		return false;
+	}
+	
+	/* Disable medium and high level interrupts so the step interrupt doesn't load a move while planning */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	if (timer->CTRLA == 0)
+	{
+		start_rotation(steps, motor_index);
+		
+		/* Didn't start because the motor is at the travel limit */
+		if (timer->CTRLA == 0)
+		{
+			PMIC_CTRL = pmic_ctrl;
+			return true;
+		}
+		
+		blended_move_queue_count[motor_index] = 0;
+		blended_move_nominal_interval[motor_index] = nominal_interval;
+		blended_move_exit_interval[motor_index] = m_max_pulse_interval_us[motor_index];
+		blended_move_running_mask |= (1 << motor_index);
+	}
+	else
+	{
+		/* Position where the queue ends */
+		int32_t position = (int32_t)(steps_target[motor_index] - steps_count[motor_index]);
+		
+		if (!moving_positive[motor_index])
+			position = -position;
+		
+		position += app_regs.REG_ACCUMULATED_STEPS[motor_index];
+		
+		for (uint8_t k = 0; k < blended_move_queue_count[motor_index]; k++)
+		{
+			position += blended_move_queue_steps[motor_index][blended_move_queue_index(motor_index, k)];
+		}
+		
+		/* Moves are clamped to the travel limits when queued, so the planning decelerates ahead of them */
+		steps = clamp_to_travel_limits(steps, position, motor_index);
+		
+		if (steps != 0)
+		{
+			uint8_t index = blended_move_queue_index(motor_index, blended_move_queue_count[motor_index]);
+			
+			blended_move_queue_steps[motor_index][index] = steps;
+			blended_move_queue_nominal[motor_index][index] = nominal_interval;
+			blended_move_queue_count[motor_index]++;
+			
+			blended_move_plan(motor_index);
+		}
+	}
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	return true;
+}
+
+bool blended_move_can_push (uint8_t motor_index)
+{
+	if (motor_peripherals_timer[motor_index]->CTRLA == 0)
+	{
+		/* A quick movement may be about to start */
+		if (motor_index == 1 && m1_quick_count_down) return false;
+		if (motor_index == 2 && m2_quick_count_down) return false;
+		
+		return true;
+	}
+	
+	/* Other moves can't be blended */
+	if (!(blended_move_running_mask & (1 << motor_index)))
+		return false;
+	
+	return (blended_move_queue_count[motor_index] < BLENDED_MOVE_QUEUE_SIZE) ? true : false;
+}
+
+bool blended_move_is_running (uint8_t motor_index)
+{
+	return (blended_move_running_mask & (1 << motor_index)) ? true : false;
+}
+
+uint8_t blended_move_get_pending (uint8_t motor_index)
+{
+	if (!(blended_move_running_mask & (1 << motor_index)))
+		return 0;
+	
+	return blended_move_queue_count[motor_index] + 1;
+}
+
+void blended_move_flush (uint8_t motor_index, uint32_t stop_target)
+{
+	/* The running move may end before the motor can decelerate, so it takes the steps it needs from the following moves */
+	for (uint8_t k = 0; k < blended_move_queue_count[motor_index] && steps_target[motor_index] < stop_target; k++)
+	{
+		int32_t steps = blended_move_queue_steps[motor_index][blended_move_queue_index(motor_index, k)];
+		
+		/* Reversals go through the maximum interval, so the motor can stop before them */
+		if ((steps > 0) != moving_positive[motor_index])
+			break;
+		
+		uint32_t available = (uint32_t)((steps < 0) ? -steps : steps);
+		uint32_t needed = stop_target - steps_target[motor_index];
+		
+		steps_target[motor_index] += (available < needed) ? available : needed;
+	}
+	
+	blended_move_queue_count[motor_index] = 0;
+	blended_move_exit_interval[motor_index] = m_max_pulse_interval_us[motor_index];
+}
+
+void blended_move_abort (uint8_t motor_index)
+{
+	blended_move_queue_count[motor_index] = 0;
+	blended_move_running_mask &= ~(1 << motor_index);
+}
+
+bool blended_move_next (uint8_t motor_index)
+{
+	if (blended_move_queue_count[motor_index] == 0)
+	{
+		return false;
+	}
+	
+	uint8_t index = blended_move_queue_head[motor_index];
+	int32_t steps = blended_move_queue_steps[motor_index][index];
+	
+	blended_move_queue_head[motor_index] = (index + 1) % BLENDED_MOVE_QUEUE_SIZE;
+	blended_move_queue_count[motor_index]--;
+	
+	if (steps > 0)
+	{
+		motor_peripherals_dir_port[motor_index]->OUTSET = (1<<motor_peripherals_dir_pin_index[motor_index]);
+		moving_positive[motor_index] = true;
+		steps_target[motor_index] = (uint32_t)steps;
+	}
+	else
+	{
+		motor_peripherals_dir_port[motor_index]->OUTCLR = (1<<motor_peripherals_dir_pin_index[motor_index]);
+		moving_positive[motor_index] = false;
+		steps_target[motor_index] = (uint32_t)(~steps + 1);
+	}
+	
+	steps_count[motor_index] = 0;
+	
+	blended_move_nominal_interval[motor_index] = blended_move_queue_nominal[motor_index][index];
+	blended_move_exit_interval[motor_index] = blended_move_queue_exit[motor_index][index];
+	
+	return true;
+}
@@ -0,0 +1,42 @@
+#ifndef _BLENDED_MOVE_H_
+#define _BLENDED_MOVE_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Moves queued for each motor after the one running
+#define BLENDED_MOVE_QUEUE_SIZE 8
+
+/************************************************************************/
+/* Blended move routines                                                */
+/************************************************************************/
+/* Queues a move, starting it if the motor is stopped, nominal_interval is in timer counts */
+bool blended_move_push (uint8_t motor_index, int32_t steps, uint16_t nominal_interval);
+bool blended_move_can_push (uint8_t motor_index);
+
+bool blended_move_is_running (uint8_t motor_index);
+
+/* Number of moves not yet completed, including the one running */
+uint8_t blended_move_get_pending (uint8_t motor_index);
+
+/* Drops the queued moves, so the running one decelerates until stop at its end */
+/* The running move is first extended through the following moves in the same direction, up to stop_target steps */
+void blended_move_flush (uint8_t motor_index, uint32_t stop_target);
+
+/* Called when the motor is stopped */
+void blended_move_abort (uint8_t motor_index);
+
+/* Called from the step interrupt at the end of each move, returns true if the next one was loaded */
+bool blended_move_next (uint8_t motor_index);
+
+#endif /* _BLENDED_MOVE_H_ */
@@ -0,0 +1,293 @@
+#include "closed_loop.h"
+#include "stepper_control.h"
+#include "encoders.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+extern int32_t user_requested_steps[MOTORS_QUANTITY];
+extern bool send_motor_stopped_notification[MOTORS_QUANTITY];
+extern uint8_t encoders_enabled_mask;
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+// Difference, in steps, between the motor and the encoder when the following error was zeroed
+int32_t closed_loop_offset[ENCODERS_QUANTITY];
+
+// Motors currently above the following error threshold
+uint8_t closed_loop_error_mask = 0;
+
+// Motors whose following error is zeroed at the next closed_loop_process()
+uint8_t closed_loop_resync_mask = 0;
+
+// Position correction at the end of the moves
+uint8_t closed_loop_state[ENCODERS_QUANTITY] = {CLOSED_LOOP_IDLE, CLOSED_LOOP_IDLE, CLOSED_LOOP_IDLE};
+uint8_t closed_loop_settle_counter[ENCODERS_QUANTITY];
+uint8_t closed_loop_corrections_count[ENCODERS_QUANTITY];
+int32_t closed_loop_corrected_steps[ENCODERS_QUANTITY];
+int32_t closed_loop_expected_steps[ENCODERS_QUANTITY];
+uint8_t closed_loop_stopped_mask = 0;
+uint8_t closed_loop_corrected_mask = 0;
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+static int32_t closed_loop_read_steps (uint8_t motor_index)
+{
+	int32_t steps;
+	
+	/* Disable medium and high level interrupts so the steps don't change while copied */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	steps = app_regs.REG_ACCUMULATED_STEPS[motor_index];
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	return steps;
+}
+
+static int32_t closed_loop_encoder_in_steps (uint8_t motor_index)
+{
+	return (int32_t)(encoders_get_sampled_position(motor_index) * app_regs.REG_MOTORS_STEPS_PER_COUNT[motor_index]);
+}
+
+static bool closed_loop_drive_is_enabled (uint8_t motor_index)
+{
+	switch (motor_index)
+	{
+		case 0:  return read_DRIVE_ENABLE_M0 ? false : true;
+		case 1:  return read_DRIVE_ENABLE_M1 ? false : true;
+		default: return read_DRIVE_ENABLE_M2 ? false : true;
+	}
+}
+
+static void closed_loop_correction_finish (uint8_t motor_index)
+{
+	closed_loop_state[motor_index] = CLOSED_LOOP_IDLE;
+	app_regs.REG_POSITION_CORRECTION[motor_index] = closed_loop_corrected_steps[motor_index];
+	
+	if (closed_loop_corrected_steps[motor_index] == 0)
+		return;
+	
+	/* The corrective steps replaced lost steps, so they don't count as motion */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	app_regs.REG_ACCUMULATED_STEPS[motor_index] -= closed_loop_corrected_steps[motor_index];
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+	
+	closed_loop_corrected_mask |= (1 << motor_index);
+}
+
+static void closed_loop_correction_check (uint8_t motor_index)
+{
+	/* Distance to the target of the original move */
+	int32_t correction = closed_loop_get_following_error(motor_index) - closed_loop_corrected_steps[motor_index];
+	int32_t distance = (correction < 0) ? -correction : correction;
+	
+	if (distance <= app_regs.REG_POSITION_CORRECTION_TOLERANCE[motor_index] ||
+		closed_loop_corrections_count[motor_index] >= CLOSED_LOOP_MAX_CORRECTIONS ||
+		!closed_loop_drive_is_enabled(motor_index) ||
+		!(encoders_enabled_mask & (1 << motor_index)))
+	{
+		closed_loop_correction_finish(motor_index);
+		closed_loop_stopped_mask |= (1 << motor_index);
+		return;
+	}
+	
+	/* Corrections only replace a few lost steps, a larger error means a faulty encoder or a stall */
+	uint32_t limit = app_regs.REG_FOLLOWING_ERROR_THRESHOLD[motor_index];
+	
+	if (limit == 0)
+		limit = (uint32_t)app_regs.REG_POSITION_CORRECTION_TOLERANCE[motor_index] * CLOSED_LOOP_MAX_CORRECTION_RATIO;
+	
+	if (distance > limit)
+	{
+		closed_loop_correction_finish(motor_index);
+		closed_loop_stopped_mask |= (1 << motor_index);
+		
+		closed_loop_error_mask |= (1 << motor_index);
+		app_regs.REG_FOLLOWING_ERROR_DETECTED = closed_loop_error_mask;
+		core_func_send_event(ADD_REG_FOLLOWING_ERROR_DETECTED, true);
+		return;
+	}
+	
+	closed_loop_corrections_count[motor_index]++;
+	closed_loop_corrected_steps[motor_index] += correction;
+	closed_loop_expected_steps[motor_index] = closed_loop_read_steps(motor_index) + correction;
+	closed_loop_state[motor_index] = CLOSED_LOOP_CORRECTING;
+	
+	/* Disable medium and high level interrupts */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	start_rotation(correction, motor_index);
+	
+	/* Re-enable all interrupt levels */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+}
+
+
+/************************************************************************/
+/* Closed loop routines                                                 */
+/************************************************************************/
+void closed_loop_resync (uint8_t motors_mask)
+{
+	/* Disable all interrupt levels, the request can come from the inputs' interrupts */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm;
+	
+	closed_loop_resync_mask |= motors_mask;
+	
+	PMIC_CTRL = pmic_ctrl;
+}
+
+int32_t closed_loop_get_following_error (uint8_t motor_index)
+{
+	return closed_loop_read_steps(motor_index) - closed_loop_encoder_in_steps(motor_index) - closed_loop_offset[motor_index];
+}
+
+void closed_loop_process (void)
+{
+	uint8_t detected_mask = 0;
+	uint8_t stopped_mask = 0;
+	
+	/* Disable all interrupt levels while taking the requested resyncs */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm;
+	
+	uint8_t resync_mask = closed_loop_resync_mask;
+	closed_loop_resync_mask = 0;
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (resync_mask & (1 << i))
+		{
+			closed_loop_offset[i] = closed_loop_read_steps(i) - closed_loop_encoder_in_steps(i);
+			closed_loop_error_mask &= ~(1 << i);
+		}
+	}
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (closed_loop_state[i] == CLOSED_LOOP_SETTLING)
+		{
+			if (motor_peripherals_timer[i]->CTRLA != 0 || user_requested_steps[i] != 0)
+			{
+				/* A new move was started by the host */
+				closed_loop_correction_finish(i);
+				closed_loop_stopped_mask |= (1 << i);
+			}
+			else if (--closed_loop_settle_counter[i] == 0)
+			{
+				closed_loop_correction_check(i);
+			}
+		}
+		else if (closed_loop_state[i] == CLOSED_LOOP_CORRECTING)
+		{
+			/* Stopped without reaching the end, the stop was already reported */
+			if (motor_peripherals_timer[i]->CTRLA == 0 && !send_motor_stopped_notification[i])
+				closed_loop_correction_finish(i);
+		}
+	}
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		uint16_t threshold = app_regs.REG_FOLLOWING_ERROR_THRESHOLD[i];
+		
+		/* A disabled encoder reads 0, so there is nothing to compare with */
+		if (threshold == 0 || !(encoders_enabled_mask & (1 << i)))
+			continue;
+		
+		int32_t error = closed_loop_get_following_error(i);
+		
+		if (error < 0)
+			error = -error;
+		
+		if (error <= threshold)
+		{
+			closed_loop_error_mask &= ~(1 << i);
+			continue;
+		}
+		
+		/* Only the first tick above the threshold is reported */
+		if (closed_loop_error_mask & (1 << i))
+			continue;
+		
+		closed_loop_error_mask |= (1 << i);
+		detected_mask |= (1 << i);
+		
+		if (app_regs.REG_FOLLOWING_ERROR_STOP_MOTORS & (1 << i))
+		{
+			/* Disable medium and high level interrupts */
+			PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+			
+			/* Drops any request not yet started so the motor stays stopped */
+			user_requested_steps[i] = 0;
+			
+			if (if_moving_stop_rotation(i))
+				stopped_mask |= (1 << i);
+			
+			/* Re-enable all interrupt levels */
+			PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+		}
+	}
+	
+	if (detected_mask)
+	{
+		app_regs.REG_FOLLOWING_ERROR_DETECTED = closed_loop_error_mask;
+		core_func_send_event(ADD_REG_FOLLOWING_ERROR_DETECTED, true);
+		
+		if (stopped_mask)
+			send_motors_stopped_event(stopped_mask);
+	}
+}
+
+bool closed_loop_motor_stopped (uint8_t motor_index)
+{
+	if (motor_index >= ENCODERS_QUANTITY)
+		return true;
+	
+	if (closed_loop_state[motor_index] == CLOSED_LOOP_CORRECTING)
+	{
+		/* The corrective move was changed by the host, so the target is no longer known */
+		if (closed_loop_read_steps(motor_index) != closed_loop_expected_steps[motor_index])
+		{
+			closed_loop_correction_finish(motor_index);
+			return true;
+		}
+	}
+	else
+	{
+		if (app_regs.REG_POSITION_CORRECTION_TOLERANCE[motor_index] == 0 || !(encoders_enabled_mask & (1 << motor_index)))
+			return true;
+		
+		closed_loop_corrections_count[motor_index] = 0;
+		closed_loop_corrected_steps[motor_index] = 0;
+	}
+	
+	/* Wait for the mechanics to settle before reading the encoder */
+	closed_loop_settle_counter[motor_index] = CLOSED_LOOP_SETTLE_TICKS;
+	closed_loop_state[motor_index] = CLOSED_LOOP_SETTLING;
+	
+	return false;
+}
+
+uint8_t closed_loop_take_stopped_motors (void)
+{
+	uint8_t stopped_mask = closed_loop_stopped_mask;
+	
+	if (closed_loop_corrected_mask)
+	{
+		core_func_send_event(ADD_REG_POSITION_CORRECTION, true);
+		closed_loop_corrected_mask = 0;
+	}
+	
+	closed_loop_stopped_mask = 0;
+	
+	return stopped_mask;
+}
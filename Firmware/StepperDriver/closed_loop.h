@@ -0,0 +1,52 @@
+#ifndef _CLOSED_LOOP_H_
+#define _CLOSED_LOOP_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Core ticks (500 us) waited after a stop before the position is checked (10 ms)
+#define CLOSED_LOOP_SETTLE_TICKS 20
+
+// Maximum number of corrective moves at the end of each move
+#define CLOSED_LOOP_MAX_CORRECTIONS 3
+
+// Without a following error threshold, corrections above this many times the tolerance are reported as errors
+#define CLOSED_LOOP_MAX_CORRECTION_RATIO 10
+
+/************************************************************************/
+/* Position correction states                                           */
+/************************************************************************/
+#define CLOSED_LOOP_IDLE         0	// No correction running
+#define CLOSED_LOOP_SETTLING     1	// Move ended, waiting before checking the position
+#define CLOSED_LOOP_CORRECTING   2	// Corrective move running
+
+/************************************************************************/
+/* Closed loop routines                                                 */
+/************************************************************************/
+/* Motors 0 to 2 are followed by the encoder with the same index */
+
+/* Zeroes the following error of the motors at the next closed_loop_process(), must be called when their steps or encoders are changed */
+void closed_loop_resync (uint8_t motors_mask);
+
+int32_t closed_loop_get_following_error (uint8_t motor_index);
+
+/* Called at every core tick, after encoders_update() */
+void closed_loop_process (void);
+
+/* Called when a move ends, returns false if the stop is delayed by a position correction */
+bool closed_loop_motor_stopped (uint8_t motor_index);
+
+/* Returns the motors whose corrections ended since the last call and sends the corrections' event */
+uint8_t closed_loop_take_stopped_motors (void);
+
+#endif /* _CLOSED_LOOP_H_ */
@@ -0,0 +1,270 @@
+#include "encoders.h"
+#include "app_ios_and_regs.h"
+
+extern AppRegs app_regs;
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Define timer used by each encoder (only timer type 1 are accepted)
+TC1_t* encoder_peripherals_timer[ENCODERS_QUANTITY] = {&TCE1, &TCF1, &TCD1};
+
+// Define the event channel and port used by each encoder, the B phase is on pin 5
+register8_t* encoder_peripherals_evsys_ctrl[ENCODERS_QUANTITY] = {&EVSYS_CH4CTRL, &EVSYS_CH2CTRL, &EVSYS_CH0CTRL};
+PORT_t* encoder_peripherals_port[ENCODERS_QUANTITY] = {&PORTE, &PORTF, &PORTD};
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+uint16_t encoder_previous_count[ENCODERS_QUANTITY] = {0x8000, 0x8000, 0x8000};
+int32_t encoder_position[ENCODERS_QUANTITY];
+
+int32_t encoder_velocity_raw[ENCODERS_QUANTITY];			// Counts per second
+int32_t encoder_velocity_filtered[ENCODERS_QUANTITY];		// Counts per second with 4 fractional bits
+uint16_t encoder_updates_since_count[ENCODERS_QUANTITY];
+
+uint8_t encoder_batch_index = 0;
+int16_t encoder_batch_previous[ENCODERS_QUANTITY];
+
+// Position at the last index pulse and the counter captured by the input's interrupt
+int32_t encoder_index_origin[ENCODERS_QUANTITY];
+uint16_t encoder_index_count[ENCODERS_QUANTITY];
+uint8_t encoder_index_pending_mask = 0;
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+static void encoder_update_velocity (uint8_t encoder_index, int16_t counts)
+{
+	uint16_t updates = encoder_updates_since_count[encoder_index];
+	
+	if (updates < 0xFFFF)
+	{
+		updates++;
+	}
+	
+	if (counts != 0)
+	{
+		if (updates == 1)
+		{
+			/* High speed, use the counts' difference */
+			encoder_velocity_raw[encoder_index] = (int32_t)counts * ENCODERS_UPDATE_FREQUENCY;
+		}
+		else
+		{
+			/* Low speed, use the interval since the previous count */
+			encoder_velocity_raw[encoder_index] = (int32_t)counts * ENCODERS_UPDATE_FREQUENCY / updates;
+		}
+		
+		updates = 0;
+	}
+	else if (updates >= ENCODERS_VELOCITY_TIMEOUT)
+	{
+		encoder_velocity_raw[encoder_index] = 0;
+	}
+	else if (encoder_velocity_raw[encoder_index] != 0)
+	{
+		/* Without new counts the speed is at most one count over the elapsed interval */
+		int32_t bound = (uint16_t)ENCODERS_UPDATE_FREQUENCY / updates;
+		
+		if (encoder_velocity_raw[encoder_index] > bound)
+			encoder_velocity_raw[encoder_index] = bound;
+		else if (encoder_velocity_raw[encoder_index] < -bound)
+			encoder_velocity_raw[encoder_index] = -bound;
+	}
+	
+	encoder_updates_since_count[encoder_index] = updates;
+	
+	int32_t target = encoder_velocity_raw[encoder_index] * 16;
+	int32_t difference = target - encoder_velocity_filtered[encoder_index];
+	
+	/* Round half away from zero so negative velocities settle like positive ones */
+	if (difference >= 0)
+		difference = (difference + (1 << (ENCODERS_VELOCITY_FILTER_SHIFT - 1))) >> ENCODERS_VELOCITY_FILTER_SHIFT;
+	else
+		difference = -((-difference + (1 << (ENCODERS_VELOCITY_FILTER_SHIFT - 1))) >> ENCODERS_VELOCITY_FILTER_SHIFT);
+	
+	/* Within half a filter step of the target, so settle on it */
+	if (difference == 0)
+		encoder_velocity_filtered[encoder_index] = target;
+	else
+		encoder_velocity_filtered[encoder_index] += difference;
+}
+
+
+/************************************************************************/
+/* Encoder routines                                                     */
+/************************************************************************/
+void encoders_update (void)
+{
+	uint16_t count[ENCODERS_QUANTITY];
+	
+	/* Disable all interrupt levels and read the counters back to back so they are sampled at the same instant */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm;
+	
+	count[0] = TCE1_CNT;
+	count[1] = TCF1_CNT;
+	count[2] = TCD1_CNT;
+	
+	uint8_t index_mask = encoder_index_pending_mask;
+	encoder_index_pending_mask = 0;
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		/* The index pulse happened after the previous update */
+		if (index_mask & (1 << i))
+		{
+			encoder_index_origin[i] = encoder_position[i] + (int16_t)(encoder_index_count[i] - encoder_previous_count[i]);
+		}
+		
+		/* The 16-bit difference is correct across the counter's overflow and underflow */
+		int16_t counts = (int16_t)(count[i] - encoder_previous_count[i]);
+		
+		encoder_position[i] += counts;
+		encoder_previous_count[i] = count[i];
+		
+		encoder_update_velocity(i, counts);
+	}
+}
+
+int32_t encoders_get_position (uint8_t encoder_index)
+{
+	/* Includes the counts since the last update */
+	return encoder_position[encoder_index] + (int16_t)(encoder_peripherals_timer[encoder_index]->CNT - encoder_previous_count[encoder_index]);
+}
+
+int16_t encoders_get_sampled_count (uint8_t encoder_index)
+{
+	/* The counters start at 0x8000 */
+	return (int16_t)(encoder_previous_count[encoder_index] - 0x8000);
+}
+
+int32_t encoders_get_sampled_position (uint8_t encoder_index)
+{
+	return encoder_position[encoder_index];
+}
+
+float encoders_get_velocity (uint8_t encoder_index)
+{
+	return encoder_velocity_filtered[encoder_index] / 16.0;
+}
+
+int32_t encoders_get_velocity_fixed (uint8_t encoder_index)
+{
+	return encoder_velocity_filtered[encoder_index];
+}
+
+uint8_t encoders_batch_add_sample (int16_t *batch, uint8_t encoders_mask)
+{
+	uint8_t index = encoder_batch_index;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		int16_t count = (encoders_mask & (1 << i)) ? encoders_get_sampled_count(i) : 0;
+		
+		/* The first sample contains the readings and the next ones the differences to the previous sample */
+		if (index == 0)
+			batch[i] = count;
+		else
+			batch[index * ENCODERS_QUANTITY + i] = count - encoder_batch_previous[i];
+		
+		encoder_batch_previous[i] = count;
+	}
+	
+	if (++encoder_batch_index == ENCODERS_BATCH_SAMPLES)
+	{
+		encoder_batch_index = 0;
+	}
+	
+	return index;
+}
+
+void encoders_batch_restart (void)
+{
+	encoder_batch_index = 0;
+}
+
+void encoders_reset (uint8_t encoders_mask)
+{
+	/* Disable all interrupt levels so the update can't run between the counter and position resets */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (encoders_mask & (1 << i))
+		{
+			encoder_peripherals_timer[i]->CNT = 0x8000;
+			encoder_previous_count[i] = 0x8000;
+			encoder_position[i] = 0;
+			encoder_index_origin[i] = 0;
+			encoder_index_pending_mask &= ~(1 << i);
+		}
+	}
+	
+	PMIC_CTRL = pmic_ctrl;
+}
+
+void encoders_configure (uint8_t encoder_index, uint8_t configuration)
+{
+	/* The digital filter takes the lower bits of the event channel control */
+	*encoder_peripherals_evsys_ctrl[encoder_index] = EVSYS_QDEN_bm | (configuration & MSK_ENCODER_FILTER);
+	
+	/* Inverting the B phase swaps the order of the phases, which reverses the counting direction */
+	if (configuration & B_ENCODER_INVERT_DIRECTION)
+		encoder_peripherals_port[encoder_index]->PIN5CTRL |= PORT_INVEN_bm;
+	else
+		encoder_peripherals_port[encoder_index]->PIN5CTRL &= ~PORT_INVEN_bm;
+}
+
+uint8_t encoders_get_mode (uint8_t encoder_index)
+{
+	return (app_regs.REG_ENCODERS_MODE >> (encoder_index * 2)) & MSK_ENCODER_MODE;
+}
+
+int32_t encoders_get_index_position (uint8_t encoder_index)
+{
+	return encoders_get_position(encoder_index) - encoder_index_origin[encoder_index];
+}
+
+int32_t encoders_get_sampled_index_position (uint8_t encoder_index)
+{
+	return encoder_position[encoder_index] - encoder_index_origin[encoder_index];
+}
+
+void encoders_index_restart (uint8_t encoders_mask)
+{
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (encoders_mask & (1 << i))
+		{
+			encoder_index_origin[i] = encoder_position[i];
+		}
+	}
+}
+
+void encoders_index_input_edge (uint8_t input_index, bool rising)
+{
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		if (encoders_get_mode(i) != GM_ENCODER_INDEX_RESET)
+			continue;
+		
+		uint8_t config = app_regs.REG_ENCODERS_INDEX_CONFIGURATION[i];
+		
+		if ((config & MSK_ENCODER_INDEX_INPUT) != input_index)
+			continue;
+		
+		/* Only the configured edge is the index pulse */
+		if (((config & B_ENCODER_INDEX_ON_FALLING) ? !rising : rising) == false)
+			continue;
+		
+		/* The position is only updated by encoders_update(), so the counter is kept until then */
+		encoder_index_count[i] = encoder_peripherals_timer[i]->CNT;
+		encoder_index_pending_mask |= (1 << i);
+	}
+}
@@ -0,0 +1,69 @@
+#ifndef _ENCODERS_H_
+#define _ENCODERS_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Define number of available encoders
+#define ENCODERS_QUANTITY 3
+
+// Define the rate, in Hz, at which encoders_update() is called
+#define ENCODERS_UPDATE_FREQUENCY 2000
+
+// Number of updates without counts until the velocity is considered zero (500 ms)
+#define ENCODERS_VELOCITY_TIMEOUT 1000
+
+// Velocity low-pass filter coefficient is 1/(2^ENCODERS_VELOCITY_FILTER_SHIFT)
+#define ENCODERS_VELOCITY_FILTER_SHIFT 3
+
+// Number of samples sent in each batch event
+#define ENCODERS_BATCH_SAMPLES 8
+
+/************************************************************************/
+/* Encoder routines                                                     */
+/************************************************************************/
+/* Samples all the counters, must be called at least once every 32768 counts of each encoder */
+void encoders_update (void);
+
+int32_t encoders_get_position (uint8_t encoder_index);
+
+/* Values sampled at the same instant by the last encoders_update() */
+int16_t encoders_get_sampled_count (uint8_t encoder_index);
+int32_t encoders_get_sampled_position (uint8_t encoder_index);
+float encoders_get_velocity (uint8_t encoder_index);
+
+/* Counts per second with 4 fractional bits */
+int32_t encoders_get_velocity_fixed (uint8_t encoder_index);
+
+/* Adds the last sample to the batch and returns its index within the batch */
+uint8_t encoders_batch_add_sample (int16_t *batch, uint8_t encoders_mask);
+void encoders_batch_restart (void);
+void encoders_reset (uint8_t encoders_mask);
+
+/* Applies the digital filter and direction of REG_ENCODERS_CONFIGURATION */
+void encoders_configure (uint8_t encoder_index, uint8_t configuration);
+
+/* Mode of the encoder selected in REG_ENCODERS_MODE */
+uint8_t encoders_get_mode (uint8_t encoder_index);
+
+/* Position since the last index pulse */
+int32_t encoders_get_index_position (uint8_t encoder_index);
+int32_t encoders_get_sampled_index_position (uint8_t encoder_index);
+
+/* Restarts the position since the index pulse from the current position */
+void encoders_index_restart (uint8_t encoders_mask);
+
+/* Called from the digital inputs' interrupts */
+void encoders_index_input_edge (uint8_t input_index, bool rising);
+
+#endif /* _ENCODERS_H_ */
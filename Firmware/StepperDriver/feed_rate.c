@@ -0,0 +1,73 @@
+#include "feed_rate.h"
+#include "stepper_control.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+// Override applied to each motor, in 1/16 %
+uint16_t feed_rate_applied[MOTORS_QUANTITY] = {100 * 16, 100 * 16, 100 * 16, 100 * 16};
+
+// Multiplier of the step intervals with 8 fractional bits, 256 is 100 %
+uint16_t feed_rate_interval_scale[MOTORS_QUANTITY] = {256, 256, 256, 256};
+
+
+/************************************************************************/
+/* Feed rate routines                                                   */
+/************************************************************************/
+uint16_t feed_rate_scale_interval (uint16_t interval, uint8_t motor_index, uint16_t minimum_interval)
+{
+	uint16_t scale = feed_rate_interval_scale[motor_index];
+	
+	if (scale == 256)
+		return interval;
+	
+	uint32_t scaled = ((uint32_t)interval * scale) >> 8;
+	
+	if (scaled > 0xFFFF)
+		return 0xFFFF;
+	
+	/* Speeding up never goes below the minimum, unless the move was already faster */
+	if (scaled < minimum_interval)
+		return (interval < minimum_interval) ? interval : minimum_interval;
+	
+	return (uint16_t)scaled;
+}
+
+void feed_rate_process (void)
+{
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		uint16_t target = (uint16_t)(((uint32_t)app_regs.REG_FEED_RATE_OVERRIDE * app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[i] * 16) / 100);
+		uint16_t applied = feed_rate_applied[i];
+		
+		if (target < FEED_RATE_MINIMUM_PERCENT * 16) target = FEED_RATE_MINIMUM_PERCENT * 16;
+		if (target > FEED_RATE_MAXIMUM_PERCENT * 16) target = FEED_RATE_MAXIMUM_PERCENT * 16;
+		
+		if (applied == target)
+			continue;
+		
+		/* A stopped motor takes the new override at once, a running one is slewed to it */
+		if (motor_peripherals_timer[i]->CTRLA == 0)
+			applied = target;
+		else if (applied < target)
+			applied = (target - applied > FEED_RATE_SLEW_RATE) ? applied + FEED_RATE_SLEW_RATE : target;
+		else
+			applied = (applied - target > FEED_RATE_SLEW_RATE) ? applied - FEED_RATE_SLEW_RATE : target;
+		
+		feed_rate_applied[i] = applied;
+		
+		/* Disable medium and high level interrupts so the step interrupts see a consistent scale */
+		PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+		
+		feed_rate_interval_scale[i] = (uint16_t)((256UL * 100 * 16) / applied);
+		
+		/* Re-enable all interrupt levels */
+		PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+	}
+}
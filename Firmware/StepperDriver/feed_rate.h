@@ -0,0 +1,37 @@
+#ifndef _FEED_RATE_H_
+#define _FEED_RATE_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Range, in %, accepted by the override registers
+#define FEED_RATE_MINIMUM_PERCENT 10
+#define FEED_RATE_MAXIMUM_PERCENT 200
+
+// Change of the applied override, in 1/16 %, at each millisecond (100 % takes 400 ms)
+#define FEED_RATE_SLEW_RATE 4
+
+// Shortest intervals, in timer counts, reached by speeding up the moves
+#define FEED_RATE_MINIMUM_INTERVAL 50			// 100 us, the minimum of the step interval registers
+#define FEED_RATE_QUICK_MINIMUM_INTERVAL 11		//  22 us, the minimum the quick movements can run
+
+/************************************************************************/
+/* Feed rate routines                                                   */
+/************************************************************************/
+/* Returns the interval, in timer counts, scaled by the override applied to the motor */
+uint16_t feed_rate_scale_interval (uint16_t interval, uint8_t motor_index, uint16_t minimum_interval);
+
+/* Called every millisecond to slew the applied overrides to the registers' values */
+void feed_rate_process (void);
+
+#endif /* _FEED_RATE_H_ */
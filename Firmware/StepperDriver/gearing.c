@@ -0,0 +1,271 @@
+#include <math.h>
+#include "gearing.h"
+#include "stepper_control.h"
+#include "encoders.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+extern PORT_t* motor_peripherals_dir_port[MOTORS_QUANTITY];
+extern const uint8_t motor_peripherals_dir_pin_index[MOTORS_QUANTITY];
+extern PORT_t* motor_peripherals_led_port[MOTORS_QUANTITY];
+extern const uint8_t motor_peripherals_led_pin_index[MOTORS_QUANTITY];
+
+extern uint8_t encoders_enabled_mask;
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+// Motor and encoder positions when the following started
+int32_t gearing_origin_steps[MOTORS_QUANTITY];
+int32_t gearing_origin_encoder[MOTORS_QUANTITY];
+
+// Speed, in steps/s, commanded at the last update
+float gearing_speed[MOTORS_QUANTITY];
+
+// Motors whose timer was started by the gearing
+uint8_t gearing_timer_running_mask = 0;
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+static int32_t gearing_read_steps (uint8_t motor_index)
+{
+	int32_t steps;
+	
+	/* Disable medium and high level interrupts so the steps don't change while copied */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	steps = app_regs.REG_ACCUMULATED_STEPS[motor_index];
+	
+	/* Re-enable all interrupt levels */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+	
+	return steps;
+}
+
+static bool gearing_drive_is_enabled (uint8_t motor_index)
+{
+	switch (motor_index)
+	{
+		case 0:  return read_DRIVE_ENABLE_M0 ? false : true;
+		case 1:  return read_DRIVE_ENABLE_M1 ? false : true;
+		case 2:  return read_DRIVE_ENABLE_M2 ? false : true;
+		default: return read_DRIVE_ENABLE_M3 ? false : true;
+	}
+}
+
+static void gearing_stop_timer (uint8_t motor_index)
+{
+	if (gearing_timer_running_mask & (1 << motor_index))
+	{
+		stop_rotation(motor_index);
+		gearing_timer_running_mask &= ~(1 << motor_index);
+	}
+}
+
+static void gearing_update_timer (uint8_t motor_index, float speed)
+{
+	TC0_t* timer = motor_peripherals_timer[motor_index];
+	
+	if (speed > 0)
+		motor_peripherals_dir_port[motor_index]->OUTSET = (1<<motor_peripherals_dir_pin_index[motor_index]);
+	else
+	{
+		motor_peripherals_dir_port[motor_index]->OUTCLR = (1<<motor_peripherals_dir_pin_index[motor_index]);
+		speed = -speed;
+	}
+	
+	/* The timer runs at 2 us per count, as with REG_MOTORn_IMMEDIATE_STEPS */
+	uint16_t period = (uint16_t)(500000 / speed);
+	
+	if (gearing_timer_running_mask & (1 << motor_index))
+	{
+		/* The speed changes at every update, so the buffer avoids a period shorter than the count */
+		timer->PERBUF = period - 1;
+	}
+	else
+	{
+		timer_type0_pwm(timer, TIMER_PRESCALER_DIV64, period, 3, INT_LEVEL_LOW, INT_LEVEL_OFF);
+		gearing_timer_running_mask |= (1 << motor_index);
+		
+		if (core_bool_is_visual_enabled())
+			motor_peripherals_led_port[motor_index]->OUTSET = (1<<motor_peripherals_led_pin_index[motor_index]);
+	}
+}
+
+static float gearing_limit_speed (uint8_t motor_index, float speed, int32_t steps)
+{
+	int32_t max_position = *((&app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION) + motor_index);
+	int32_t min_position = *((&app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION) + motor_index);
+	float distance;
+	
+	/* As in manage_step_boundaries(), a limit equal to 0 is disabled */
+	/* The motor stops one step before the limit, since reaching it stops the timer and releases the gearing */
+	if (speed > 0 && max_position != 0)
+		distance = (float)max_position - steps - 1;
+	else if (speed < 0 && min_position != 0)
+		distance = (float)steps - min_position - 1;
+	else
+		return speed;
+	
+	if (distance <= 0)
+		return 0;
+	
+	/* Fastest speed that can still decelerate until stop before the limit */
+	float allowed;
+	
+	if (app_regs.REG_GEARING_ACCELERATION[motor_index] > 0)
+		allowed = sqrt(2 * app_regs.REG_GEARING_ACCELERATION[motor_index] * distance);
+	else
+		allowed = distance * GEARING_UPDATE_FREQUENCY;
+	
+	if (speed > allowed) return allowed;
+	if (speed < -allowed) return -allowed;
+	
+	return speed;
+}
+
+static void gearing_release (uint8_t motor_index)
+{
+	gearing_stop_timer(motor_index);
+	gearing_speed[motor_index] = 0;
+	
+	app_regs.REG_GEARING_CONFIGURATION[motor_index] &= ~B_GEARING_ENABLE;
+	core_func_send_event(ADD_REG_GEARING_CONFIGURATION, true);
+}
+
+
+/************************************************************************/
+/* Gearing routines                                                     */
+/************************************************************************/
+bool gearing_configure (uint8_t motor_index, uint8_t configuration)
+{
+	if ((configuration & MSK_GEARING_ENCODER) >= ENCODERS_QUANTITY)
+		return false;
+	
+	if (configuration & B_GEARING_ENABLE)
+	{
+		/* The master encoder must be sampled */
+		if (!(encoders_enabled_mask & (1 << (configuration & MSK_GEARING_ENCODER))))
+			return false;
+		
+		if (!gearing_is_running(motor_index))
+		{
+			/* Only engages a stopped motor */
+			if (motor_peripherals_timer[motor_index]->CTRLA != 0)
+				return false;
+			
+			app_regs.REG_GEARING_CONFIGURATION[motor_index] = configuration;
+			gearing_restart(motor_index);
+			
+			return true;
+		}
+		
+		/* Changing the encoder restarts the following */
+		if ((configuration ^ app_regs.REG_GEARING_CONFIGURATION[motor_index]) & MSK_GEARING_ENCODER)
+		{
+			app_regs.REG_GEARING_CONFIGURATION[motor_index] = configuration;
+			gearing_restart(motor_index);
+		}
+	}
+	else
+	{
+		gearing_stop_timer(motor_index);
+		gearing_speed[motor_index] = 0;
+	}
+	
+	app_regs.REG_GEARING_CONFIGURATION[motor_index] = configuration;
+	
+	return true;
+}
+
+void gearing_restart (uint8_t motor_index)
+{
+	gearing_origin_steps[motor_index] = gearing_read_steps(motor_index);
+	gearing_origin_encoder[motor_index] = encoders_get_sampled_position(app_regs.REG_GEARING_CONFIGURATION[motor_index] & MSK_GEARING_ENCODER);
+}
+
+bool gearing_is_running (uint8_t motor_index)
+{
+	return (app_regs.REG_GEARING_CONFIGURATION[motor_index] & B_GEARING_ENABLE) ? true : false;
+}
+
+void gearing_process (void)
+{
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (!gearing_is_running(i))
+			continue;
+		
+		/* Released when the motor is stopped or moved by anything else */
+		if ((gearing_timer_running_mask & (1 << i)) && (motor_peripherals_timer[i]->CTRLA == 0 || motor_peripherals_timer[i]->INTCTRLB != 0))
+		{
+			gearing_timer_running_mask &= ~(1 << i);
+			gearing_release(i);
+			continue;
+		}
+		
+		if (motor_peripherals_timer[i]->CTRLA != 0 && !(gearing_timer_running_mask & (1 << i)))
+		{
+			gearing_release(i);
+			continue;
+		}
+		
+		if (!gearing_drive_is_enabled(i))
+		{
+			gearing_stop_timer(i);
+			gearing_speed[i] = 0;
+			continue;
+		}
+		
+		uint8_t encoder = app_regs.REG_GEARING_CONFIGURATION[i] & MSK_GEARING_ENCODER;
+		bool encoder_enabled = (encoders_enabled_mask & (1 << encoder)) ? true : false;
+		float ratio = app_regs.REG_GEARING_RATIO[i];
+		
+		int32_t steps = gearing_read_steps(i);
+		float speed = 0;
+		
+		/* Without the master encoder the motor decelerates until stop and is released */
+		if (encoder_enabled)
+		{
+			int32_t target = gearing_origin_steps[i] + (int32_t)((encoders_get_sampled_position(encoder) - gearing_origin_encoder[i]) * ratio);
+			int32_t error = target - steps;
+			
+			/* The encoder's speed is fed forward and the position error is corrected proportionally */
+			speed = encoders_get_velocity(encoder) * ratio + (float)error * GEARING_POSITION_GAIN;
+		}
+		
+		float maximum = app_regs.REG_GEARING_MAXIMUM_SPEED[i];
+		
+		if (maximum > GEARING_SPEED_LIMIT || maximum <= 0)
+			maximum = GEARING_SPEED_LIMIT;
+		
+		if (speed > maximum) speed = maximum;
+		if (speed < -maximum) speed = -maximum;
+		
+		if (app_regs.REG_GEARING_ACCELERATION[i] > 0)
+		{
+			float speed_step = app_regs.REG_GEARING_ACCELERATION[i] / GEARING_UPDATE_FREQUENCY;
+			
+			if (speed > gearing_speed[i] + speed_step) speed = gearing_speed[i] + speed_step;
+			if (speed < gearing_speed[i] - speed_step) speed = gearing_speed[i] - speed_step;
+		}
+		
+		speed = gearing_limit_speed(i, speed, steps);
+		
+		gearing_speed[i] = speed;
+		
+		/* Below the minimum speed the timer's period would overflow */
+		if (speed < GEARING_MINIMUM_SPEED && speed > -GEARING_MINIMUM_SPEED)
+			gearing_stop_timer(i);
+		else
+			gearing_update_timer(i, speed);
+		
+		if (!encoder_enabled && !(gearing_timer_running_mask & (1 << i)))
+			gearing_release(i);
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef _GEARING_H_
+#define _GEARING_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Rate, in Hz, at which gearing_process() is called
+#define GEARING_UPDATE_FREQUENCY 2000
+
+// Speed, in steps/s, added for each step of position error
+#define GEARING_POSITION_GAIN 50
+
+// The step interval is limited to 100 us and the timer period to 65535 x 2 us
+#define GEARING_SPEED_LIMIT 10000
+#define GEARING_MINIMUM_SPEED 8
+
+/************************************************************************/
+/* Gearing routines                                                     */
+/************************************************************************/
+/* Engages or releases the motors according to REG_GEARING_CONFIGURATION */
+bool gearing_configure (uint8_t motor_index, uint8_t configuration);
+
+/* Restarts the following from the current motor and encoder positions */
+void gearing_restart (uint8_t motor_index);
+
+bool gearing_is_running (uint8_t motor_index);
+
+/* Called at every core tick, after encoders_update() */
+void gearing_process (void);
+
+#endif /* _GEARING_H_ */
@@ -0,0 +1,274 @@
+#include "stepper_control.h"
+#include "homing.h"
+#include "closed_loop.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+extern int32_t user_requested_steps[MOTORS_QUANTITY];
+extern bool send_motor_stopped_notification[MOTORS_QUANTITY];
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+uint8_t homing_state[MOTORS_QUANTITY] = {HOMING_IDLE, HOMING_IDLE, HOMING_IDLE, HOMING_IDLE};
+uint8_t homing_back_off_retries[MOTORS_QUANTITY];
+
+uint8_t homing_succeeded_mask = 0;
+uint8_t homing_failed_mask = 0;
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+static bool homing_switch_is_active (uint8_t motor_index)
+{
+	bool input_state;
+
+	switch (app_regs.REG_HOMING_CONFIGURATION[motor_index] & MSK_HOMING_INPUT)
+	{
+		case 0:  input_state = (read_INPUT0) ? false : true; break;
+		case 1:  input_state = (read_INPUT1) ? false : true; break;
+		case 2:  input_state = (read_INPUT2) ? false : true; break;
+		default: input_state = (read_INPUT3) ? false : true; break;
+	}
+
+	/* The switch is active after the configured edge */
+	if (app_regs.REG_HOMING_CONFIGURATION[motor_index] & B_HOMING_ON_FALLING)
+	{
+		return !input_state;
+	}
+
+	return input_state;
+}
+
+static int32_t homing_towards_switch (uint8_t motor_index, int32_t steps)
+{
+	return (app_regs.REG_HOMING_CONFIGURATION[motor_index] & B_HOMING_POSITIVE_DIRECTION) ? steps : -steps;
+}
+
+static void homing_move (uint8_t motor_index, int32_t steps, uint16_t nominal_interval, uint16_t initial_interval)
+{
+	update_nominal_pulse_interval(nominal_interval, motor_index);
+	update_initial_pulse_interval((initial_interval > nominal_interval) ? initial_interval : nominal_interval, motor_index);
+
+	/* Disable medium and high level interrupts, homing_process() may have disabled the low level too */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL &= ~(PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm);
+
+	user_requested_steps[motor_index] = 0;
+	start_rotation(steps, motor_index);
+
+	PMIC_CTRL = pmic_ctrl;
+}
+
+static void homing_back_off (uint8_t motor_index)
+{
+	uint16_t slow = app_regs.REG_HOMING_SLOW_STEP_INTERVAL[motor_index];
+
+	homing_move(motor_index, homing_towards_switch(motor_index, -(int32_t)app_regs.REG_HOMING_BACK_OFF_STEPS[motor_index]), slow, slow);
+	homing_state[motor_index] = HOMING_BACK_OFF;
+}
+
+static void homing_finish (uint8_t motor_index, bool success)
+{
+	/* Restore the motor's configured movement parameters */
+	update_nominal_pulse_interval(*((&app_regs.REG_MOTOR0_NOMINAL_STEP_INTERVAL) + motor_index), motor_index);
+	update_initial_pulse_interval(*((&app_regs.REG_MOTOR0_MAXIMUM_STEP_INTERVAL) + motor_index), motor_index);
+
+	/* The homing event replaces the motor stopped notification */
+	send_motor_stopped_notification[motor_index] = false;
+
+	homing_state[motor_index] = HOMING_IDLE;
+
+	if (success)
+		homing_succeeded_mask |= (1 << motor_index);
+	else
+		homing_failed_mask |= (1 << motor_index);
+}
+
+
+/************************************************************************/
+/* Homing routines                                                      */
+/************************************************************************/
+bool homing_start (uint8_t motor_index)
+{
+	if (motor_index >= MOTORS_QUANTITY)
+	{
+		return false;
+	}
+
+	/* Only starts if the motor is stopped */
+	if (motor_peripherals_timer[motor_index]->CTRLA != 0)
+	{
+		return false;
+	}
+
+	homing_succeeded_mask &= ~(1 << motor_index);
+	homing_failed_mask &= ~(1 << motor_index);
+	homing_back_off_retries[motor_index] = 0;
+	
+	/* The positions change, so a paused move can't be resumed */
+	pause_discard(motor_index);
+
+	if (homing_switch_is_active(motor_index))
+	{
+		/* Already at the switch, skip the fast seek */
+		homing_back_off(motor_index);
+	}
+	else
+	{
+		uint32_t seek_steps = app_regs.REG_HOMING_MAXIMUM_STEPS[motor_index];
+
+		/* The seek is always bounded, so a missing switch ends the homing as failed */
+		if (seek_steps == 0)
+		{
+			seek_steps = HOMING_DEFAULT_MAXIMUM_STEPS;
+		}
+		
+		if (seek_steps > 0x7FFFFFFF)
+		{
+			seek_steps = 0x7FFFFFFF;
+		}
+
+		homing_move(motor_index, homing_towards_switch(motor_index, (int32_t)seek_steps),
+			app_regs.REG_HOMING_FAST_STEP_INTERVAL[motor_index],
+			*((&app_regs.REG_MOTOR0_MAXIMUM_STEP_INTERVAL) + motor_index));
+		homing_state[motor_index] = HOMING_FAST_SEEK;
+	}
+
+	return true;
+}
+
+bool homing_is_running (uint8_t motor_index)
+{
+	return (homing_state[motor_index] != HOMING_IDLE) ? true : false;
+}
+
+bool homing_input_is_enabled (uint8_t motor_index)
+{
+	switch (app_regs.REG_HOMING_CONFIGURATION[motor_index] & MSK_HOMING_INPUT)
+	{
+		case 0:  return (PORTK.INT0MASK & (1<<5)) ? true : false;
+		case 1:  return (PORTQ.INT0MASK & (1<<2)) ? true : false;
+		case 2:  return (PORTC.INT0MASK & (1<<5)) ? true : false;
+		default: return (PORTH.INT0MASK & (1<<7)) ? true : false;
+	}
+}
+
+bool homing_is_running_on_input (uint8_t motor_index, uint8_t input_index)
+{
+	if (homing_state[motor_index] == HOMING_IDLE)
+		return false;
+
+	return ((app_regs.REG_HOMING_CONFIGURATION[motor_index] & MSK_HOMING_INPUT) == input_index) ? true : false;
+}
+
+void homing_input_edge (uint8_t input_index, bool rising)
+{
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if ((app_regs.REG_HOMING_CONFIGURATION[i] & MSK_HOMING_INPUT) != input_index)
+			continue;
+
+		/* Only the edge that activates the switch is used */
+		if (((app_regs.REG_HOMING_CONFIGURATION[i] & B_HOMING_ON_FALLING) ? !rising : rising) == false)
+			continue;
+
+		if (homing_state[i] == HOMING_FAST_SEEK)
+		{
+			reduce_until_stop_rotation(i);
+			homing_state[i] = HOMING_FAST_STOP;
+		}
+		else if (homing_state[i] == HOMING_SLOW_APPROACH)
+		{
+			/* Disable medium and high level interrupts so the steps and their resync request change together */
+			uint8_t pmic_ctrl = PMIC_CTRL;
+			PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+			
+			/* At slow speed the motor can stop immediately at the edge */
+			stop_rotation(i);
+			app_regs.REG_ACCUMULATED_STEPS[i] = 0;
+			closed_loop_resync(1 << i);
+			
+			PMIC_CTRL = pmic_ctrl;
+			homing_state[i] = HOMING_LATCHED;
+		}
+	}
+}
+
+void homing_process (void)
+{
+	bool running = false;
+
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (homing_state[i] == HOMING_IDLE)
+			continue;
+
+		/* Disable all interrupt levels, the input interrupts also change homing_state */
+		uint8_t pmic_ctrl = PMIC_CTRL;
+		PMIC_CTRL = PMIC_RREN_bm;
+
+		bool stopped = (motor_peripherals_timer[i]->CTRLA == 0) ? true : false;
+
+		switch (homing_state[i])
+		{
+			case HOMING_FAST_SEEK:
+				/* Stopped before reaching the switch */
+				if (stopped) homing_finish(i, false);
+				break;
+
+			case HOMING_FAST_STOP:
+				if (stopped) homing_back_off(i);
+				break;
+
+			case HOMING_BACK_OFF:
+				if (stopped)
+				{
+					if (homing_switch_is_active(i))
+					{
+						/* Overshoot was longer than the back off distance */
+						if (++homing_back_off_retries[i] > HOMING_MAX_BACK_OFF_RETRIES)
+							homing_finish(i, false);
+						else
+							homing_back_off(i);
+					}
+					else
+					{
+						uint16_t slow = app_regs.REG_HOMING_SLOW_STEP_INTERVAL[i];
+
+						homing_move(i, homing_towards_switch(i, 2 * (int32_t)app_regs.REG_HOMING_BACK_OFF_STEPS[i]), slow, slow);
+						homing_state[i] = HOMING_SLOW_APPROACH;
+					}
+				}
+				break;
+
+			case HOMING_SLOW_APPROACH:
+				/* Stopped before reaching the switch */
+				if (stopped) homing_finish(i, false);
+				break;
+
+			case HOMING_LATCHED:
+				homing_finish(i, true);
+				break;
+		}
+
+		if (homing_state[i] != HOMING_IDLE)
+			running = true;
+
+		PMIC_CTRL = pmic_ctrl;
+	}
+
+	/* Send a single event when all the requested motors are done */
+	if ((homing_succeeded_mask | homing_failed_mask) && !running)
+	{
+		app_regs.REG_HOMING_DONE = homing_succeeded_mask | (homing_failed_mask << 4);
+		core_func_send_event(ADD_REG_HOMING_DONE, true);
+
+		homing_succeeded_mask = 0;
+		homing_failed_mask = 0;
+	}
+}
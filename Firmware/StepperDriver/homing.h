@@ -0,0 +1,47 @@
+#ifndef _HOMING_H_
+#define _HOMING_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* Homing states                                                        */
+/************************************************************************/
+#define HOMING_IDLE            0	// Not homing
+#define HOMING_FAST_SEEK       1	// Moving fast towards the switch
+#define HOMING_FAST_STOP       2	// Switch found, decelerating until stop
+#define HOMING_BACK_OFF        3	// Moving away from the switch
+#define HOMING_SLOW_APPROACH   4	// Moving slowly towards the switch
+#define HOMING_LATCHED         5	// Switch found at slow speed, position zeroed
+
+#define HOMING_MAX_BACK_OFF_RETRIES 8
+
+// Seek distance used when REG_HOMING_MAXIMUM_STEPS is 0
+#define HOMING_DEFAULT_MAXIMUM_STEPS 1000000
+
+/************************************************************************/
+/* Homing routines                                                      */
+/************************************************************************/
+bool homing_start (uint8_t motor_index);
+bool homing_is_running (uint8_t motor_index);
+
+/* True if the digital input configured as the motor's home switch has its interrupt enabled */
+bool homing_input_is_enabled (uint8_t motor_index);
+
+/* True if the motor is homing on this input, so the input doesn't stop it */
+bool homing_is_running_on_input (uint8_t motor_index, uint8_t input_index);
+
+/* Called from the digital inputs' interrupts */
+void homing_input_edge (uint8_t input_index, bool rising);
+
+/* Called every 1 ms */
+void homing_process (void);
+
+#endif /* _HOMING_H_ */
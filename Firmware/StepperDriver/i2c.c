@@ -117,6 +117,71 @@ bool i2c0_wReg(i2c_dev_t* dev)
 	return true;
 }
 
+bool i2c0_wRegs(i2c_dev_t* dev, uint8_t regs2write)
+{
+	/* dev->data[] holds the pairs [reg, reg_val] to write on the same device */
+	/* The bus is kept between pairs using a Repeat Start, so it's never released */
+	if (regs2write * 2 > MAX_I2C_DATA)
+		return false;
+	i2c0_start();
+	
+	uint8_t add = (dev->add << 1);
+	uint8_t byte;
+	
+	for (uint8_t i = 0; i < regs2write; i++) {
+		if (i != 0) {
+			/* Repeat Start */
+			clear_SCL0;
+			set_SDA0;
+			tCLK_I2C0;
+			set_SCL0;
+			tSUSTA;
+			clear_SDA0;
+			tHDSTA;
+		}
+		
+		// Each cycle
+		//   __
+		//__|
+		clear_SCL0;	if (add & 0x80) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;	if (add & 0x40) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;	if (add & 0x20) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;	if (add & 0x10) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;	if (add & 0x08) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;	if (add & 0x04) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;	if (add & 0x02) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		clear_SCL0;								   clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		
+		clear_SCL0;	set_SDA0; tCLK_I2C0; set_SCL0; tCLK_I2C0;
+		if(read_SDA0) {
+			i2c0_stop();
+			return false;
+		}
+		
+		for (uint8_t j = 0; j < 2; j++) {
+			byte = dev->data[i*2 + j];
+			
+			clear_SCL0;	if (byte & 0x80) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x40) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x20) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x10) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x08) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x04) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x02) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			clear_SCL0;	if (byte & 0x01) set_SDA0; else clear_SDA0;	tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			
+			clear_SCL0;	set_SDA0; tCLK_I2C0; set_SCL0; tCLK_I2C0;
+			if(read_SDA0) {
+				i2c0_stop();
+				return false;
+			}
+		}
+	}
+	
+	i2c0_stop();
+	return true;
+}
+
 bool i2c0_wReg_slowly(i2c_dev_t* dev)
 {
 	switch (slowly_state)
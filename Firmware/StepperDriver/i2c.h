@@ -207,6 +207,7 @@ typedef struct {
 #ifdef I2C0_CLK
 	void i2c0_init(void);
 	bool i2c0_wReg(i2c_dev_t* dev);
+	bool i2c0_wRegs(i2c_dev_t* dev, uint8_t regs2write);
 	bool i2c0_wReg_slowly(i2c_dev_t* dev);
 	bool i2c0_rReg(i2c_dev_t* dev, uint8_t bytes2read);
 	bool i2c0_rReg_slowly(i2c_dev_t* dev, uint8_t bytes2read);
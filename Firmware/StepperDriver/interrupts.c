@@ -5,6 +5,9 @@
 #include "hwbp_core.h"
 
 #include "stepper_control.h"
+#include "homing.h"
+#include "triggered_move.h"
+#include "encoders.h"
 
 /************************************************************************/
 /* Declare application registers                                        */
@@ -31,6 +34,70 @@ extern AppRegs app_regs;
 
 uint8_t inputs_previous_read = 0;
 
+/************************************************************************/ 
+/* Position latch                                                       */
+/************************************************************************/
+static void latch_positions (void)
+{
+	/* Disable medium and high level interrupts so the steps don't change while copied */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	app_regs.REG_LATCHED_POSITIONS[0] = app_regs.REG_ACCUMULATED_STEPS[0];
+	app_regs.REG_LATCHED_POSITIONS[1] = app_regs.REG_ACCUMULATED_STEPS[1];
+	app_regs.REG_LATCHED_POSITIONS[2] = app_regs.REG_ACCUMULATED_STEPS[2];
+	app_regs.REG_LATCHED_POSITIONS[3] = app_regs.REG_ACCUMULATED_STEPS[3];
+	
+	app_regs.REG_LATCHED_POSITIONS[4] = encoders_get_position(0);
+	app_regs.REG_LATCHED_POSITIONS[5] = encoders_get_position(1);
+	app_regs.REG_LATCHED_POSITIONS[6] = encoders_get_position(2);
+	
+	PMIC_CTRL = pmic_ctrl;
+}
+
+/************************************************************************/ 
+/* Input stop                                                           */
+/************************************************************************/
+static uint8_t stop_motors_from_input (uint8_t operation_mode, uint8_t input_index)
+{
+	uint8_t motor_stopped_mask = 0;
+	uint8_t motors_mask;
+	
+	/* The GM_STOP_MOTORn_ON_* values select a single motor by its index */
+	if (operation_mode & B_INPUT_STOP_MOTORS_MASK)
+		motors_mask = operation_mode & MSK_INPUT_STOP_MOTORS;
+	else
+		motors_mask = 1 << (operation_mode & MSK_INPUT_STOP_MOTOR_INDEX);
+	
+	/* Disable medium and high level interrupts so all the selected motors stop in the same pass */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (!(motors_mask & (1 << i)))
+			continue;
+		
+		/* The homing sequence stops the motor itself when this input is its home switch */
+		if (homing_is_running_on_input(i, input_index))
+			continue;
+		
+		if (operation_mode & B_INPUT_STOP_DECELERATING)
+		{
+			/* The motors stopped event is sent when the ramp down ends, or right away for motors that can't ramp down */
+			reduce_until_stop_rotation(i);
+		}
+		else if (if_moving_stop_rotation(i))
+		{
+			motor_stopped_mask |= (1 << i);
+		}
+	}
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	return motor_stopped_mask;
+}
+
 /************************************************************************/ 
 /* INPUT0                                                               */
 /************************************************************************/
@@ -39,34 +106,56 @@ ISR(PORTK_INT0_vect, ISR_NAKED)
 	uint8_t inputs_current_read = inputs_previous_read;
 	
 	uint8_t motor_stopped_mask = 0;
+	uint8_t latched_edge = 0;
 	
 	if (read_INPUT0)
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT0_ON_FALLING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read &= ~B_INPUT0;
 		
-		if (app_regs.REG_INPUT0_OPERATION_MODE & 0x20)	// Means it's configured to stop when falling
+		homing_input_edge(0, false);
+		
+		if (app_regs.REG_INPUT0_OPERATION_MODE & B_INPUT_STOP_ON_FALLING)	// Means it's configured to stop when falling
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT0_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT0_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT0_OPERATION_MODE, 0);
 		}
 	}
 	else
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT0_ON_RISING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read |= B_INPUT0;
 		
-		if (app_regs.REG_INPUT0_OPERATION_MODE & 0x10)	// Means it's configured to stop when rising
+		homing_input_edge(0, true);
+		
+		if (app_regs.REG_INPUT0_OPERATION_MODE & B_INPUT_STOP_ON_RISING)	// Means it's configured to stop when rising
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT0_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT0_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT0_OPERATION_MODE, 0);
 		}
 	}
 	
+	encoders_index_input_edge(0, (inputs_current_read & B_INPUT0) ? true : false);
+	
 	if (inputs_current_read != inputs_previous_read)
 	{
+		/* Only a real edge launches a triggered move, not a glitch that reads the same level */
+		triggered_move_input_edge(0, (inputs_current_read & B_INPUT0) ? true : false);
+		
 		app_regs.REG_DIGITAL_INPUTS_STATE = ((inputs_previous_read ^ inputs_current_read) << 4) | (inputs_current_read & 0x0F);
 		core_func_send_event(ADD_REG_DIGITAL_INPUTS_STATE, true);
 		
 		inputs_previous_read = inputs_current_read;
 	}
 	
+	if (latched_edge)
+	{
+		app_regs.REG_LATCHED_POSITIONS[7] = latched_edge;
+		core_func_send_event(ADD_REG_LATCHED_POSITIONS, true);
+	}
+	
 	if (motor_stopped_mask)
 	{
 		send_motors_stopped_event(motor_stopped_mask);
@@ -83,34 +172,56 @@ ISR(PORTQ_INT0_vect, ISR_NAKED)
 	uint8_t inputs_current_read = inputs_previous_read;
 	
 	uint8_t motor_stopped_mask = 0;
+	uint8_t latched_edge = 0;
 	
 	if (read_INPUT1)
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT1_ON_FALLING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read &= ~B_INPUT1;
 		
-		if (app_regs.REG_INPUT1_OPERATION_MODE & 0x20)	// Means it's configured to stop when falling
+		homing_input_edge(1, false);
+		
+		if (app_regs.REG_INPUT1_OPERATION_MODE & B_INPUT_STOP_ON_FALLING)	// Means it's configured to stop when falling
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT1_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT1_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT1_OPERATION_MODE, 1);
 		}
 	}
 	else
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT1_ON_RISING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read |= B_INPUT1;
 		
-		if (app_regs.REG_INPUT1_OPERATION_MODE & 0x10)	// Means it's configured to stop when rising
+		homing_input_edge(1, true);
+		
+		if (app_regs.REG_INPUT1_OPERATION_MODE & B_INPUT_STOP_ON_RISING)	// Means it's configured to stop when rising
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT1_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT1_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT1_OPERATION_MODE, 1);
 		}
 	}
 	
+	encoders_index_input_edge(1, (inputs_current_read & B_INPUT1) ? true : false);
+	
 	if (inputs_current_read != inputs_previous_read)
 	{
+		/* Only a real edge launches a triggered move, not a glitch that reads the same level */
+		triggered_move_input_edge(1, (inputs_current_read & B_INPUT1) ? true : false);
+		
 		app_regs.REG_DIGITAL_INPUTS_STATE = ((inputs_previous_read ^ inputs_current_read) << 4) | (inputs_current_read & 0x0F);
 		core_func_send_event(ADD_REG_DIGITAL_INPUTS_STATE, true);
 		
 		inputs_previous_read = inputs_current_read;
 	}
 	
+	if (latched_edge)
+	{
+		app_regs.REG_LATCHED_POSITIONS[7] = latched_edge;
+		core_func_send_event(ADD_REG_LATCHED_POSITIONS, true);
+	}
+	
 	if (motor_stopped_mask)
 	{
 		send_motors_stopped_event(motor_stopped_mask);
@@ -127,34 +238,56 @@ ISR(PORTC_INT0_vect, ISR_NAKED)
 	uint8_t inputs_current_read = inputs_previous_read;
 	
 	uint8_t motor_stopped_mask = 0;
+	uint8_t latched_edge = 0;
 	
 	if (read_INPUT2)
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT2_ON_FALLING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read &= ~B_INPUT2;
 		
-		if (app_regs.REG_INPUT2_OPERATION_MODE & 0x20)	// Means it's configured to stop when falling
+		homing_input_edge(2, false);
+		
+		if (app_regs.REG_INPUT2_OPERATION_MODE & B_INPUT_STOP_ON_FALLING)	// Means it's configured to stop when falling
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT2_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT2_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT2_OPERATION_MODE, 2);
 		}
 	}
 	else
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT2_ON_RISING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read |= B_INPUT2;
 		
-		if (app_regs.REG_INPUT2_OPERATION_MODE & 0x10)	// Means it's configured to stop when rising
+		homing_input_edge(2, true);
+		
+		if (app_regs.REG_INPUT2_OPERATION_MODE & B_INPUT_STOP_ON_RISING)	// Means it's configured to stop when rising
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT2_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT2_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT2_OPERATION_MODE, 2);
 		}
 	}
 	
+	encoders_index_input_edge(2, (inputs_current_read & B_INPUT2) ? true : false);
+	
 	if (inputs_current_read != inputs_previous_read)
 	{
+		/* Only a real edge launches a triggered move, not a glitch that reads the same level */
+		triggered_move_input_edge(2, (inputs_current_read & B_INPUT2) ? true : false);
+		
 		app_regs.REG_DIGITAL_INPUTS_STATE = ((inputs_previous_read ^ inputs_current_read) << 4) | (inputs_current_read & 0x0F);
 		core_func_send_event(ADD_REG_DIGITAL_INPUTS_STATE, true);
 		
 		inputs_previous_read = inputs_current_read;
 	}
 	
+	if (latched_edge)
+	{
+		app_regs.REG_LATCHED_POSITIONS[7] = latched_edge;
+		core_func_send_event(ADD_REG_LATCHED_POSITIONS, true);
+	}
+	
 	if (motor_stopped_mask)
 	{
 		send_motors_stopped_event(motor_stopped_mask);
@@ -171,34 +304,56 @@ ISR(PORTH_INT0_vect, ISR_NAKED)
 	uint8_t inputs_current_read = inputs_previous_read;
 	
 	uint8_t motor_stopped_mask = 0;
+	uint8_t latched_edge = 0;
 	
 	if (read_INPUT3)
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT3_ON_FALLING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read &= ~B_INPUT3;
 		
-		if (app_regs.REG_INPUT3_OPERATION_MODE & 0x20)	// Means it's configured to stop when falling
+		homing_input_edge(3, false);
+		
+		if (app_regs.REG_INPUT3_OPERATION_MODE & B_INPUT_STOP_ON_FALLING)	// Means it's configured to stop when falling
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT3_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT3_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT3_OPERATION_MODE, 3);
 		}
 	}
 	else
 	{
+		latched_edge = app_regs.REG_POSITION_LATCH_MODE & B_LATCH_INPUT3_ON_RISING;
+		if (latched_edge) latch_positions();
+		
 		inputs_current_read |= B_INPUT3;
 		
-		if (app_regs.REG_INPUT3_OPERATION_MODE & 0x10)	// Means it's configured to stop when rising
+		homing_input_edge(3, true);
+		
+		if (app_regs.REG_INPUT3_OPERATION_MODE & B_INPUT_STOP_ON_RISING)	// Means it's configured to stop when rising
 		{
-			motor_stopped_mask = (if_moving_stop_rotation(app_regs.REG_INPUT3_OPERATION_MODE & 0x0F)) ? (app_regs.REG_INPUT3_OPERATION_MODE & 0x0F) : 0;
+			motor_stopped_mask = stop_motors_from_input(app_regs.REG_INPUT3_OPERATION_MODE, 3);
 		}
 	}
 	
+	encoders_index_input_edge(3, (inputs_current_read & B_INPUT3) ? true : false);
+	
 	if (inputs_current_read != inputs_previous_read)
 	{
+		/* Only a real edge launches a triggered move, not a glitch that reads the same level */
+		triggered_move_input_edge(3, (inputs_current_read & B_INPUT3) ? true : false);
+		
 		app_regs.REG_DIGITAL_INPUTS_STATE = ((inputs_previous_read ^ inputs_current_read) << 4) | (inputs_current_read & 0x0F);
 		core_func_send_event(ADD_REG_DIGITAL_INPUTS_STATE, true);
 		
 		inputs_previous_read = inputs_current_read;
 	}
 	
+	if (latched_edge)
+	{
+		app_regs.REG_LATCHED_POSITIONS[7] = latched_edge;
+		core_func_send_event(ADD_REG_LATCHED_POSITIONS, true);
+	}
+	
 	if (motor_stopped_mask)
 	{
 		send_motors_stopped_event(motor_stopped_mask);
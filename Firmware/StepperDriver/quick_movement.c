@@ -1,5 +1,6 @@
 #include "stepper_control.h"
 #include "quick_movement.h"
+#include "feed_rate.h"
 #include "app_ios_and_regs.h"
 #include "hwbp_core.h"
 
@@ -247,6 +248,9 @@ uint16_t m2_move_pulses;
 
 uint32_t m1_speed;
 uint32_t m1_delay;
+uint16_t m1_start_delay;
+uint16_t m1_quick_backlash_pulses;
+bool m1_move_positive;
 bool m1_accelerating;
 uint16_t m1_pulses_to_accelerate;
 uint16_t m1_short_move_pulses;
@@ -257,6 +261,9 @@ bool m1_use_single_step;
 
 uint32_t m2_speed;
 uint32_t m2_delay;
+uint16_t m2_start_delay;
+uint16_t m2_quick_backlash_pulses;
+bool m2_move_positive;
 bool m2_accelerating;
 uint16_t m2_pulses_to_accelerate;
 uint16_t m2_short_move_pulses;
@@ -327,22 +334,29 @@ bool m1_update_internal_variables (void)
 		// m1_timer_limit = MINIMUM_US_BETWEEN_PULSES >> 1;	// Make sure time between pulses don't go below the minimum acceptable
 		return false;
 	
+	/* Interval of the first pulse, so m1_initiate_quick_movement() doesn't divide */
+	m1_start_delay = (uint16_t)(1000000.0/m1_speed_start);
+	m1_short_move_pulses = m1_move_pulses >> 1;
+	m1_move_positive = (app_regs.REG_MOTOR1_QUICK_DISTANCE > 0) ? true : false;
+	
+	if (m1_move_pulses <= 4)
+	{
+		return false;
+	}
+	
+	return true;
+}
+
+static void m1_reset_internal_variables (void)
+{
 	m1_speed = m1_speed_start;
 	m1_delay = 0;
 	m1_accelerating = true;
 	m1_pulses_to_accelerate = 0;
-	m1_short_move_pulses = m1_move_pulses/2.0;
 	
 	m1_exec_ctrl = 9;
 	m1_use_steps = false;
 	m1_use_single_step = false;
-	
-	if (m1_move_pulses <= 4)
-	{
-		return false;
-	}
-	
-	return true;
 }
 
 bool m2_update_internal_variables (void)
@@ -353,15 +367,10 @@ bool m2_update_internal_variables (void)
 		// m1_timer_limit = MINIMUM_US_BETWEEN_PULSES >> 1;	// Make sure time between pulses don't go below the minimum acceptable
 		return false;
 	
-	m2_speed = m1_speed_start;
-	m2_delay = 0;
-	m2_accelerating = true;
-	m2_pulses_to_accelerate = 0;
-	m2_short_move_pulses = m2_move_pulses/2.0;
-	
-	m2_exec_ctrl = 9;
-	m2_use_steps = false;
-	m2_use_single_step = false;
+	/* Interval of the first pulse, so m2_initiate_quick_movement() doesn't divide */
+	m2_start_delay = (uint16_t)(1000000.0/m2_speed_start);
+	m2_short_move_pulses = m2_move_pulses >> 1;
+	m2_move_positive = (app_regs.REG_MOTOR2_QUICK_DISTANCE > 0) ? true : false;
 	
 	if (m2_move_pulses <= 4)
 	{
@@ -371,6 +380,18 @@ bool m2_update_internal_variables (void)
 	return true;
 }
 
+static void m2_reset_internal_variables (void)
+{
+	m2_speed = m2_speed_start;
+	m2_delay = 0;
+	m2_accelerating = true;
+	m2_pulses_to_accelerate = 0;
+	
+	m2_exec_ctrl = 9;
+	m2_use_steps = false;
+	m2_use_single_step = false;
+}
+
 bool m1_launch_quick_movement (void)
 {
 	if (m1_update_internal_variables() == false)
@@ -378,18 +399,25 @@ bool m1_launch_quick_movement (void)
 		return false;
 	}
 	
+	return m1_load_quick_movement();
+}
+
+bool m1_load_quick_movement (void)
+{
 	if (read_DRIVE_ENABLE_M1)
 	{
 		return false;
 	}
 	
+	m1_reset_internal_variables();
+	
 	m1_quick_timer_per = app_regs.REG_RESERVED10 + app_regs.REG_RESERVED12;
 	m1_quick_state_ctrl = 0;
 	
 	/* Only executes the movement if the motor is stopped */
 	if_moving_stop_rotation(1);
 	
-	if (app_regs.REG_MOTOR1_QUICK_DISTANCE > 0)
+	if (m1_move_positive)
 	{
 		set_DIR_M1;
 	}
@@ -417,18 +445,25 @@ bool m2_launch_quick_movement (void)
 		return false;
 	}
 	
+	return m2_load_quick_movement();
+}
+
+bool m2_load_quick_movement (void)
+{
 	if (read_DRIVE_ENABLE_M2)
 	{
 		return false;
 	}
 	
+	m2_reset_internal_variables();
+	
 	m2_quick_timer_per = app_regs.REG_RESERVED11 + app_regs.REG_RESERVED13;
 	m2_quick_state_ctrl = 0;
 	
 	/* Only executes the movement if the motor is stopped */
 	if_moving_stop_rotation(2);
 	
-	if (app_regs.REG_MOTOR2_QUICK_DISTANCE > 0)
+	if (m2_move_positive)
 	{
 		set_DIR_M2;
 	}
@@ -456,10 +491,13 @@ void m1_initiate_quick_movement (void)
 		return;
 	}
 	
+	/* The backlash is checked once and taken up at the start interval before the profile starts */
+	m1_quick_backlash_pulses = backlash_take_up(1);
+	
 	/* Start the generation of pulses */
-	m1_delay = (uint16_t)(1000000.0/m1_speed);
+	m1_delay = m1_start_delay;
 	
-	timer_type0_pwm(&TCD0, TIMER_PRESCALER_DIV64, (m1_delay >> 1) - 1, 2 >> 1, INT_LEVEL_MED, INT_LEVEL_MED);
+	timer_type0_pwm(&TCD0, TIMER_PRESCALER_DIV64, feed_rate_scale_interval(m1_delay >> 1, 1, FEED_RATE_QUICK_MINIMUM_INTERVAL) - 1, 2 >> 1, INT_LEVEL_MED, INT_LEVEL_MED);
 	
 	if (0)//m1_delay < 6000 && m1_delay > 20)
 	{
@@ -483,10 +521,13 @@ void m2_initiate_quick_movement (void)
 		return;
 	}
 	
+	/* The backlash is checked once and taken up at the start interval before the profile starts */
+	m2_quick_backlash_pulses = backlash_take_up(2);
+	
 	/* Start the generation of pulses */
-	m2_delay = (uint16_t)(1000000.0/m2_speed);
+	m2_delay = m2_start_delay;
 	
-	timer_type0_pwm(&TCE0, TIMER_PRESCALER_DIV64, (m2_delay >> 1) - 1, 2 >> 1, INT_LEVEL_MED, INT_LEVEL_MED);
+	timer_type0_pwm(&TCE0, TIMER_PRESCALER_DIV64, feed_rate_scale_interval(m2_delay >> 1, 2, FEED_RATE_QUICK_MINIMUM_INTERVAL) - 1, 2 >> 1, INT_LEVEL_MED, INT_LEVEL_MED);
 	
 	if (0)//m2_delay < 6000 && m2_delay > 20)
 	{
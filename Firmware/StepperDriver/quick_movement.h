@@ -21,11 +21,15 @@ void m2_start_quick_movement (void);
 bool m1_recalc_internal_paramenters (void);
 bool m1_update_internal_variables (void);
 bool m1_launch_quick_movement (void);
+/* Same as m1_launch_quick_movement() without the floating point, m1_update_internal_variables() must be called before */
+bool m1_load_quick_movement (void);
 void m1_initiate_quick_movement (void);
 
 bool m2_recalc_internal_paramenters (void);
 bool m2_update_internal_variables (void);
 bool m2_launch_quick_movement (void);
+/* Same as m2_launch_quick_movement() without the floating point, m2_update_internal_variables() must be called before */
+bool m2_load_quick_movement (void);
 void m2_initiate_quick_movement (void);
 
 #endif /* _QUICK_MOVEMENT_H_ */
\ No newline at end of file
@@ -48,7 +48,14 @@ void core_callback_reset_registers(void)
 	app_regs.REG_MOTOR3_MAXIMUM_STEP_INTERVAL = 2000;
 	app_regs.REG_MOTOR3_STEP_ACCELERATION_INTERVAL = 10;	
 	
+	app_regs.REG_ENCODERS_MODE = GM_ENCODER_RAW;
 	app_regs.REG_ENCODERS_UPDATE_RATE = GM_RATE_100HZ;
+	app_regs.REG_ENCODERS_INDEX_CONFIGURATION[0] = 0;		// Input 0, rising edge
+	app_regs.REG_ENCODERS_INDEX_CONFIGURATION[1] = 1;		// Input 1, rising edge
+	app_regs.REG_ENCODERS_INDEX_CONFIGURATION[2] = 2;		// Input 2, rising edge
+	app_regs.REG_ENCODERS_CONFIGURATION[0] = GM_ENCODER_FILTER_2SAMPLES;
+	app_regs.REG_ENCODERS_CONFIGURATION[1] = GM_ENCODER_FILTER_2SAMPLES;
+	app_regs.REG_ENCODERS_CONFIGURATION[2] = GM_ENCODER_FILTER_2SAMPLES;
 	
 	app_regs.REG_INPUT0_OPERATION_MODE = GM_STOP_MOTOR0_ON_RISING;
 	app_regs.REG_INPUT1_OPERATION_MODE = GM_STOP_MOTOR1_ON_RISING;
@@ -86,6 +93,102 @@ void core_callback_reset_registers(void)
 	app_regs.REG_MOTOR2_QUICK_ACCELERATION = 1.0;
 	app_regs.REG_MOTOR1_QUICK_DISTANCE = 15.0;			// Up to travel range
 	app_regs.REG_MOTOR2_QUICK_DISTANCE = 15.0;
+	
+	app_regs.REG_HOMING_CONFIGURATION[0] = 0;			// Input 0, negative direction, rising edge
+	app_regs.REG_HOMING_CONFIGURATION[1] = 1;			// Input 1, negative direction, rising edge
+	app_regs.REG_HOMING_CONFIGURATION[2] = 2;			// Input 2, negative direction, rising edge
+	app_regs.REG_HOMING_CONFIGURATION[3] = 3;			// Input 3, negative direction, rising edge
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[0] = 500;
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[1] = 500;
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[2] = 500;
+	app_regs.REG_HOMING_FAST_STEP_INTERVAL[3] = 500;
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[0] = 4000;
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[1] = 4000;
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[2] = 4000;
+	app_regs.REG_HOMING_SLOW_STEP_INTERVAL[3] = 4000;
+	app_regs.REG_HOMING_BACK_OFF_STEPS[0] = 200;
+	app_regs.REG_HOMING_BACK_OFF_STEPS[1] = 200;
+	app_regs.REG_HOMING_BACK_OFF_STEPS[2] = 200;
+	app_regs.REG_HOMING_BACK_OFF_STEPS[3] = 200;
+	app_regs.REG_HOMING_MAXIMUM_STEPS[0] = 0;
+	app_regs.REG_HOMING_MAXIMUM_STEPS[1] = 0;
+	app_regs.REG_HOMING_MAXIMUM_STEPS[2] = 0;
+	app_regs.REG_HOMING_MAXIMUM_STEPS[3] = 0;
+	
+	app_regs.REG_POSITION_LATCH_MODE = 0;
+	
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[0] = GM_TRIGGERED_MOVE_DISABLED;
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[1] = GM_TRIGGERED_MOVE_DISABLED;
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[2] = GM_TRIGGERED_MOVE_DISABLED;
+	app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[3] = GM_TRIGGERED_MOVE_DISABLED;
+	app_regs.REG_TRIGGERED_MOVE_STEPS[0] = 0;
+	app_regs.REG_TRIGGERED_MOVE_STEPS[1] = 0;
+	app_regs.REG_TRIGGERED_MOVE_STEPS[2] = 0;
+	app_regs.REG_TRIGGERED_MOVE_STEPS[3] = 0;
+	app_regs.REG_ARM_TRIGGERED_MOVES = 0;
+	
+	app_regs.REG_TELEMETRY_MODE = GM_TELEMETRY_DISABLED;
+	app_regs.REG_TELEMETRY_RATE = GM_RATE_100HZ;
+	app_regs.REG_TELEMETRY_KEYFRAME_INTERVAL = 50;
+	app_regs.REG_TELEMETRY_FRAME_FIELDS = B_FRAME_ACCUMULATED_STEPS | B_FRAME_ENCODERS_POSITION;
+	
+	app_regs.REG_EVENTS_ON_CHANGE = 0;
+	app_regs.REG_ACCUMULATED_STEPS_DEADBAND = 0;
+	app_regs.REG_ENCODERS_DEADBAND = 0;
+	app_regs.REG_EVENTS_HEARTBEAT_INTERVAL = 1000;
+	
+	app_regs.REG_MOTORS_STEPS_PER_COUNT[0] = 1;
+	app_regs.REG_MOTORS_STEPS_PER_COUNT[1] = 1;
+	app_regs.REG_MOTORS_STEPS_PER_COUNT[2] = 1;
+	app_regs.REG_FOLLOWING_ERROR_THRESHOLD[0] = 0;
+	app_regs.REG_FOLLOWING_ERROR_THRESHOLD[1] = 0;
+	app_regs.REG_FOLLOWING_ERROR_THRESHOLD[2] = 0;
+	app_regs.REG_FOLLOWING_ERROR_STOP_MOTORS = 0;
+	app_regs.REG_POSITION_CORRECTION_TOLERANCE[0] = 0;
+	app_regs.REG_POSITION_CORRECTION_TOLERANCE[1] = 0;
+	app_regs.REG_POSITION_CORRECTION_TOLERANCE[2] = 0;
+	
+	app_regs.REG_GEARING_CONFIGURATION[0] = 0;
+	app_regs.REG_GEARING_CONFIGURATION[1] = 0;
+	app_regs.REG_GEARING_CONFIGURATION[2] = 0;
+	app_regs.REG_GEARING_CONFIGURATION[3] = 0;
+	app_regs.REG_GEARING_RATIO[0] = 1;
+	app_regs.REG_GEARING_RATIO[1] = 1;
+	app_regs.REG_GEARING_RATIO[2] = 1;
+	app_regs.REG_GEARING_RATIO[3] = 1;
+	app_regs.REG_GEARING_MAXIMUM_SPEED[0] = 2000;
+	app_regs.REG_GEARING_MAXIMUM_SPEED[1] = 2000;
+	app_regs.REG_GEARING_MAXIMUM_SPEED[2] = 2000;
+	app_regs.REG_GEARING_MAXIMUM_SPEED[3] = 2000;
+	app_regs.REG_GEARING_ACCELERATION[0] = 0;
+	app_regs.REG_GEARING_ACCELERATION[1] = 0;
+	app_regs.REG_GEARING_ACCELERATION[2] = 0;
+	app_regs.REG_GEARING_ACCELERATION[3] = 0;
+	
+	app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[0] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[1] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[2] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[3] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[0] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[1] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[2] = 0;
+	app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[3] = 0;
+	
+	app_regs.REG_FEED_RATE_OVERRIDE = 100;
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[0] = 100;
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[1] = 100;
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[2] = 100;
+	app_regs.REG_MOTORS_FEED_RATE_OVERRIDE[3] = 100;
+	
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[0] = 0;
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[1] = 0;
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[2] = 0;
+	app_regs.REG_BLENDED_MOVE_STEP_INTERVAL[3] = 0;
+	
+	app_regs.REG_BACKLASH_STEPS[0] = 0;
+	app_regs.REG_BACKLASH_STEPS[1] = 0;
+	app_regs.REG_BACKLASH_STEPS[2] = 0;
+	app_regs.REG_BACKLASH_STEPS[3] = 0;
 }
 
 void core_callback_registers_were_reinitialized(void)
@@ -95,10 +198,11 @@ void core_callback_registers_were_reinitialized(void)
 	app_write_REG_ENABLE_MOTORS(&app_regs.REG_ENABLE_MOTORS);	// Motors are disabled by io default
 	app_write_REG_ENABLE_INPUTS(&app_regs.REG_ENABLE_INPUTS);
 	app_write_REG_ENABLE_ENCODERS(&app_regs.REG_ENABLE_ENCODERS);
+	app_write_REG_ENCODERS_MODE(&app_regs.REG_ENCODERS_MODE);
+	app_write_REG_ENCODERS_CONFIGURATION(app_regs.REG_ENCODERS_CONFIGURATION);
 	
 	app_write_REG_MOTOR0_OPERATION_MODE(&app_regs.REG_MOTOR0_OPERATION_MODE);
 	app_write_REG_MOTOR0_MICROSTEP_RESOLUTION(&app_regs.REG_MOTOR0_MICROSTEP_RESOLUTION);
-	app_write_REG_MOTOR0_MAXIMUM_CURRENT_RMS(&app_regs.REG_MOTOR0_MAXIMUM_CURRENT_RMS);
 	app_write_REG_MOTOR0_HOLD_CURRENT_REDUCTION(&app_regs.REG_MOTOR0_HOLD_CURRENT_REDUCTION);
 	app_write_REG_MOTOR0_NOMINAL_STEP_INTERVAL(&app_regs.REG_MOTOR0_NOMINAL_STEP_INTERVAL);
 	app_write_REG_MOTOR0_MAXIMUM_STEP_INTERVAL(&app_regs.REG_MOTOR0_MAXIMUM_STEP_INTERVAL);
@@ -106,7 +210,6 @@ void core_callback_registers_were_reinitialized(void)
 	
 	app_write_REG_MOTOR1_OPERATION_MODE(&app_regs.REG_MOTOR1_OPERATION_MODE);
 	app_write_REG_MOTOR1_MICROSTEP_RESOLUTION(&app_regs.REG_MOTOR1_MICROSTEP_RESOLUTION);
-	app_write_REG_MOTOR1_MAXIMUM_CURRENT_RMS(&app_regs.REG_MOTOR1_MAXIMUM_CURRENT_RMS);
 	app_write_REG_MOTOR1_HOLD_CURRENT_REDUCTION(&app_regs.REG_MOTOR1_HOLD_CURRENT_REDUCTION);
 	app_write_REG_MOTOR1_NOMINAL_STEP_INTERVAL(&app_regs.REG_MOTOR1_NOMINAL_STEP_INTERVAL);
 	app_write_REG_MOTOR1_MAXIMUM_STEP_INTERVAL(&app_regs.REG_MOTOR1_MAXIMUM_STEP_INTERVAL);
@@ -114,7 +217,6 @@ void core_callback_registers_were_reinitialized(void)
 	
 	app_write_REG_MOTOR2_OPERATION_MODE(&app_regs.REG_MOTOR2_OPERATION_MODE);
 	app_write_REG_MOTOR2_MICROSTEP_RESOLUTION(&app_regs.REG_MOTOR2_MICROSTEP_RESOLUTION);
-	app_write_REG_MOTOR2_MAXIMUM_CURRENT_RMS(&app_regs.REG_MOTOR2_MAXIMUM_CURRENT_RMS);
 	app_write_REG_MOTOR2_HOLD_CURRENT_REDUCTION(&app_regs.REG_MOTOR2_HOLD_CURRENT_REDUCTION);
 	app_write_REG_MOTOR2_NOMINAL_STEP_INTERVAL(&app_regs.REG_MOTOR2_NOMINAL_STEP_INTERVAL);
 	app_write_REG_MOTOR2_MAXIMUM_STEP_INTERVAL(&app_regs.REG_MOTOR2_MAXIMUM_STEP_INTERVAL);
@@ -122,12 +224,15 @@ void core_callback_registers_were_reinitialized(void)
 	
 	app_write_REG_MOTOR3_OPERATION_MODE(&app_regs.REG_MOTOR3_OPERATION_MODE);
 	app_write_REG_MOTOR3_MICROSTEP_RESOLUTION(&app_regs.REG_MOTOR3_MICROSTEP_RESOLUTION);
-	app_write_REG_MOTOR3_MAXIMUM_CURRENT_RMS(&app_regs.REG_MOTOR3_MAXIMUM_CURRENT_RMS);
 	app_write_REG_MOTOR3_HOLD_CURRENT_REDUCTION(&app_regs.REG_MOTOR3_HOLD_CURRENT_REDUCTION);
 	app_write_REG_MOTOR3_NOMINAL_STEP_INTERVAL(&app_regs.REG_MOTOR3_NOMINAL_STEP_INTERVAL);
 	app_write_REG_MOTOR3_MAXIMUM_STEP_INTERVAL(&app_regs.REG_MOTOR3_MAXIMUM_STEP_INTERVAL);
 	app_write_REG_MOTOR3_STEP_ACCELERATION_INTERVAL(&app_regs.REG_MOTOR3_STEP_ACCELERATION_INTERVAL);
 	
+	/* Update the four digital potentiometers' wipers using only two I2C transactions */
+	app_read_REG_MOTORS_MAXIMUM_CURRENT_RMS();
+	app_write_REG_MOTORS_MAXIMUM_CURRENT_RMS(app_regs.REG_MOTORS_MAXIMUM_CURRENT_RMS);
+	
 	app_read_REG_MOTORS_ERROR_DETECTTION();
 	app_read_REG_DIGITAL_INPUTS_STATE();
 	
@@ -139,4 +244,15 @@ void core_callback_registers_were_reinitialized(void)
 	app_write_REG_MOTOR2_QUICK_START_SPEED(&app_regs.REG_MOTOR2_QUICK_START_SPEED);
 	app_write_REG_MOTOR1_QUICK_DISTANCE(&app_regs.REG_MOTOR2_QUICK_START_SPEED);
 	app_write_REG_MOTOR2_QUICK_DISTANCE(&app_regs.REG_MOTOR2_QUICK_START_SPEED);
+	
+	app_write_REG_TRIGGERED_MOVE_CONFIGURATION(app_regs.REG_TRIGGERED_MOVE_CONFIGURATION);	// Also disarms the inputs
+	app_write_REG_TELEMETRY_MODE(&app_regs.REG_TELEMETRY_MODE);
+	app_write_REG_TELEMETRY_FRAME_FIELDS(&app_regs.REG_TELEMETRY_FRAME_FIELDS);
+	app_write_REG_FOLLOWING_ERROR_THRESHOLD(app_regs.REG_FOLLOWING_ERROR_THRESHOLD);	// Also zeroes the following errors
+	
+	/* The motors only follow the encoders after being engaged by the host */
+	app_regs.REG_GEARING_CONFIGURATION[0] &= ~B_GEARING_ENABLE;
+	app_regs.REG_GEARING_CONFIGURATION[1] &= ~B_GEARING_ENABLE;
+	app_regs.REG_GEARING_CONFIGURATION[2] &= ~B_GEARING_ENABLE;
+	app_regs.REG_GEARING_CONFIGURATION[3] &= ~B_GEARING_ENABLE;
 }
\ No newline at end of file
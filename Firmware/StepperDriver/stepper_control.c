@@ -1,4 +1,6 @@
 #include "stepper_control.h"
+#include "feed_rate.h"
+#include "blended_move.h"
 #include "app_ios_and_regs.h"
 #include "hwbp_core.h"
 
@@ -31,6 +33,9 @@ uint16_t m_pulse_step_interval_us[MOTORS_QUANTITY];
 
 int16_t ramp_steps[MOTORS_QUANTITY];
 
+// Step interval of the moves' profile before the feed rate override is applied
+uint16_t m_profile_interval[MOTORS_QUANTITY];
+
 /************************************************************************/
 /* Global motion parameters                                             */
 /************************************************************************/
@@ -49,15 +54,46 @@ int32_t user_requested_steps[MOTORS_QUANTITY];
 
 bool send_motor_stopped_notification[MOTORS_QUANTITY];
 
+// Ramped immediate steps, the intervals are in timer counts and a ramp interval of 0 disables the ramp
+uint16_t m_immediate_target_interval[MOTORS_QUANTITY];
+bool m_immediate_target_positive[MOTORS_QUANTITY];
+uint16_t m_immediate_ramp_interval[MOTORS_QUANTITY];
+
+// Milliseconds since the last immediate steps update of the motors running at immediate steps
+uint16_t m_immediate_watchdog_ms[MOTORS_QUANTITY];
+uint8_t m_immediate_watchdog_mask = 0;
+
+// Paused moves, the remaining steps are signed with the direction of the move
+uint8_t m_pause_state[MOTORS_QUANTITY] = {PAUSE_NONE, PAUSE_NONE, PAUSE_NONE, PAUSE_NONE};
+int32_t m_paused_steps[MOTORS_QUANTITY];
+
+// Steps to run in the opposite direction once the move decelerates to its end
+int32_t m_reverse_steps[MOTORS_QUANTITY];
+
+// Backlash compensation, the direction of the last step is only known after the first step
+uint16_t m_backlash_remaining[MOTORS_QUANTITY];
+uint8_t m_backlash_known_mask = 0;
+uint8_t m_backlash_positive_mask = 0;
+
 /************************************************************************/
 /* Quick movement globals                                               */
 /************************************************************************/
 extern uint8_t m1_quick_count_down;
 extern uint8_t m2_quick_count_down;
 
+extern uint16_t m1_quick_backlash_pulses;
+extern uint16_t m2_quick_backlash_pulses;
+
 extern uint16_t m1_quick_relative_steps;
 extern uint16_t m2_quick_relative_steps;
 
+/************************************************************************/
+/* Blended move globals                                                 */
+/************************************************************************/
+extern uint8_t blended_move_running_mask;
+extern uint16_t blended_move_nominal_interval[MOTORS_QUANTITY];
+extern uint16_t blended_move_exit_interval[MOTORS_QUANTITY];
+
 
 /************************************************************************/
 /* Update global electrical pulse parameters                            */
@@ -136,11 +172,109 @@ bool update_pulse_period (uint16_t time_us, uint8_t motor_index)
 	return true;
 }
 
+/************************************************************************/
+/* Travel limits                                                        */
+/************************************************************************/
+int32_t clamp_to_travel_limits (int32_t requested_steps, int32_t position, uint8_t motor_index)
+{
+	int32_t max_position = *((&app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION) + motor_index);
+	int32_t min_position = *((&app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION) + motor_index);
+	
+	/* As in manage_step_boundaries(), a limit equal to 0 is disabled */
+	/* Computed in 64 bits because homing seeks with requests up to 0x7FFFFFFF */
+	if (requested_steps > 0 && max_position != 0 && (int64_t)position + requested_steps > max_position)
+	{
+		requested_steps = (max_position > position) ? (int32_t)((int64_t)max_position - position) : 0;
+	}
+	
+	if (requested_steps < 0 && min_position != 0 && (int64_t)position + requested_steps < min_position)
+	{
+		requested_steps = (min_position < position) ? (int32_t)((int64_t)min_position - position) : 0;
+	}
+	
+	return requested_steps;
+}
+
+static uint32_t get_steps_to_stop (uint8_t motor_index)
+{
+	/* Number of steps needed to go from the current interval back to the maximum interval */
+	uint16_t per = m_profile_interval[motor_index];
+	uint32_t steps_to_stop = 1;
+	
+	if (per < m_max_pulse_interval_us[motor_index])
+	{
+		steps_to_stop += (m_max_pulse_interval_us[motor_index] - per) / m_pulse_step_interval_us[motor_index];
+	}
+	
+	return steps_to_stop;
+}
+
+static void clamp_target_to_travel_limits (uint8_t motor_index)
+{
+	int32_t remaining = (int32_t)(steps_target[motor_index] - steps_count[motor_index]);
+	
+	if (!moving_positive[motor_index])
+		remaining = -remaining;
+	
+	int32_t allowed = clamp_to_travel_limits(remaining, app_regs.REG_ACCUMULATED_STEPS[motor_index], motor_index);
+	
+	if (allowed != remaining)
+	{
+		/* The move now ends at the limit, so it decelerates ahead of it */
+		uint32_t target = steps_count[motor_index] + (uint32_t)labs(allowed);
+		uint32_t stop_target = steps_count[motor_index] + get_steps_to_stop(motor_index);
+		
+		/* A limit moved inside the stopping distance is reached while decelerating and manage_step_boundaries() stops there */
+		if (target < stop_target)
+			target = stop_target;
+		
+		if (blended_move_running_mask & (1 << motor_index))
+		{
+			blended_move_flush(motor_index, target);
+		}
+		
+		if (target < steps_target[motor_index])
+			steps_target[motor_index] = target;
+	}
+}
+
+void travel_limits_update (uint8_t motor_index)
+{
+	/* Only the moves that follow steps_target are clamped, the others stop at the limit */
+	if (motor_peripherals_timer[motor_index]->CTRLA == 0 || motor_peripherals_timer[motor_index]->INTCTRLB == 0)
+	{
+		return;
+	}
+	
+	if ((motor_index == 1 && m1_quick_count_down) || (motor_index == 2 && m2_quick_count_down))
+	{
+		return;
+	}
+	
+	/* Disable medium and high level interrupts while updating the target */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	clamp_target_to_travel_limits(motor_index);
+	
+	PMIC_CTRL = pmic_ctrl;
+}
+
+
 /************************************************************************/
 /* Start & Stop functions                                               */
 /************************************************************************/
 void start_rotation (int32_t requested_steps, uint8_t motor_index)
 {
+	requested_steps = clamp_to_travel_limits(requested_steps, app_regs.REG_ACCUMULATED_STEPS[motor_index], motor_index);
+	
+	/* Already at the limit, so only notify the host */
+	if (requested_steps == 0)
+	{
+		send_motor_stopped_notification[motor_index] = true;
+		return;
+	}
+	
 	if (requested_steps > 0)
 	{
 		motor_peripherals_dir_port[motor_index]->OUTSET = (1<<motor_peripherals_dir_pin_index[motor_index]);
@@ -156,12 +290,15 @@ void start_rotation (int32_t requested_steps, uint8_t motor_index)
 	
 	steps_count[motor_index] = 0;		// Reset steps counter
 	steps_remaining[motor_index] = 0;	// Reset remaining steps
+	m_reverse_steps[motor_index] = 0;	// Reset pending reversal
 	
 	decreasing_speed[motor_index] = false;	// Reset decreasing speed flag
 	motor_is_running[motor_index] = true;	// Update global with motor state
 	
+	m_profile_interval[motor_index] = m_max_pulse_interval_us[motor_index];
+	
 	/* Start the generation of pulses */
-	timer_type0_pwm(motor_peripherals_timer[motor_index], TIMER_PRESCALER_DIV64, m_max_pulse_interval_us[motor_index], m_pulse_period_us[motor_index], INT_LEVEL_MED, INT_LEVEL_MED);
+	timer_type0_pwm(motor_peripherals_timer[motor_index], TIMER_PRESCALER_DIV64, feed_rate_scale_interval(m_max_pulse_interval_us[motor_index], motor_index, FEED_RATE_MINIMUM_INTERVAL), m_pulse_period_us[motor_index], INT_LEVEL_MED, INT_LEVEL_MED);
 	
 	if (core_bool_is_visual_enabled())
 	{
@@ -173,21 +310,168 @@ void stop_rotation (uint8_t motor_index)
 {
  	timer_type0_stop(motor_peripherals_timer[motor_index]);
  	motor_is_running[motor_index] = false;
+	m_immediate_ramp_interval[motor_index] = 0;
+	
+	/* Stopping a move while it decelerates to pause cancels the pause */
+	if (m_pause_state[motor_index] == PAUSE_DECELERATING) m_pause_state[motor_index] = PAUSE_NONE;
+	
+	blended_move_abort(motor_index);
+	m_reverse_steps[motor_index] = 0;
 	 
  	if (motor_index == 1) m1_quick_count_down = 0;
  	if (motor_index == 2) m2_quick_count_down = 0;
 	
+	/* The slack a quick movement didn't take up is still there */
+	if (motor_index == 1) { m_backlash_remaining[1] += m1_quick_backlash_pulses; m1_quick_backlash_pulses = 0; }
+	if (motor_index == 2) { m_backlash_remaining[2] += m2_quick_backlash_pulses; m2_quick_backlash_pulses = 0; }
+	
 	motor_peripherals_led_port[motor_index]->OUTCLR = (1<<motor_peripherals_led_pin_index[motor_index]);
 }
 
 void reduce_until_stop_rotation (uint8_t motor_index)
 {
- 	/* 
-	   To do: Implement a calculation to update the steps
-	   in a way that will decrease steps until stop.
-	   Meanwhile, the stop_rotation() is here to stop the motor.
-	*/
-	 stop_rotation(motor_index);
+	if (motor_peripherals_timer[motor_index]->CTRLA == 0)
+	{
+		return;
+	}
+
+	/* Ramped immediate steps decelerate in the step interrupt and notify when stopped */
+	if ((motor_peripherals_timer[motor_index]->INTCTRLB == 0) && m_immediate_ramp_interval[motor_index])
+	{
+		m_immediate_target_interval[motor_index] = 0;
+		return;
+	}
+
+	/* Immediate steps and quick movements don't follow steps_target, so stop right away */
+	if ((motor_peripherals_timer[motor_index]->INTCTRLB == 0) ||
+		(motor_index == 1 && m1_quick_count_down) ||
+		(motor_index == 2 && m2_quick_count_down))
+	{
+		stop_rotation(motor_index);
+		send_motor_stopped_notification[motor_index] = true;
+		return;
+	}
+
+	/* Disable medium and high level interrupts while updating the target */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+
+	uint32_t steps_to_stop = get_steps_to_stop(motor_index);
+
+	/* The queued moves are dropped and the running one decelerates to the maximum interval */
+	if (blended_move_running_mask & (1 << motor_index))
+	{
+		blended_move_flush(motor_index, steps_count[motor_index] + steps_to_stop);
+	}
+
+	/* A stop also cancels the pending reversal */
+	m_reverse_steps[motor_index] = 0;
+
+	if (steps_count[motor_index] + steps_to_stop < steps_target[motor_index])
+	{
+		steps_target[motor_index] = steps_count[motor_index] + steps_to_stop;
+	}
+
+	PMIC_CTRL = pmic_ctrl;
+}
+
+bool pause_rotation (uint8_t motor_index)
+{
+	/* Only moves that follow steps_target can be paused */
+	if (motor_peripherals_timer[motor_index]->CTRLA == 0 || motor_peripherals_timer[motor_index]->INTCTRLB == 0)
+	{
+		return false;
+	}
+	
+	if ((motor_index == 1 && m1_quick_count_down) || (motor_index == 2 && m2_quick_count_down))
+	{
+		return false;
+	}
+	
+	/* The rest of a blended sequence is in its queue and not in steps_target */
+	if (blended_move_running_mask & (1 << motor_index))
+	{
+		return false;
+	}
+	
+	if (m_pause_state[motor_index] != PAUSE_NONE)
+	{
+		return true;
+	}
+	
+	/* Disable medium and high level interrupts while updating the target */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	uint32_t target = steps_target[motor_index];
+	int32_t reverse_steps = m_reverse_steps[motor_index];
+	
+	reduce_until_stop_rotation(motor_index);
+	
+	/* reduce_until_stop_rotation() drops the pending reversal, but the pause keeps it */
+	m_reverse_steps[motor_index] = reverse_steps;
+	
+	/* Steps that were cut from the move, none if it was already decelerating to its end */
+	m_paused_steps[motor_index] = (int32_t)(target - steps_target[motor_index]);
+	
+	if (!moving_positive[motor_index])
+		m_paused_steps[motor_index] = -m_paused_steps[motor_index];
+	
+	/* A pending reversal is kept and added to the paused steps when the motor stops */
+	if (m_paused_steps[motor_index] != 0 || m_reverse_steps[motor_index] != 0)
+	{
+		m_pause_state[motor_index] = PAUSE_DECELERATING;
+	}
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	return (m_pause_state[motor_index] != PAUSE_NONE) ? true : false;
+}
+
+bool resume_rotation (uint8_t motor_index)
+{
+	bool resumed = false;
+	
+	/* Disable medium and high level interrupts so the move doesn't end while it's extended */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	if (m_pause_state[motor_index] == PAUSE_DECELERATING)
+	{
+		/* Still moving, so it accelerates back from the current speed */
+		steps_target[motor_index] += (uint32_t)((m_paused_steps[motor_index] < 0) ? -m_paused_steps[motor_index] : m_paused_steps[motor_index]);
+		clamp_target_to_travel_limits(motor_index);
+		m_pause_state[motor_index] = PAUSE_NONE;
+		resumed = true;
+	}
+	else if (m_pause_state[motor_index] == PAUSE_STOPPED && motor_peripherals_timer[motor_index]->CTRLA == 0)
+	{
+		m_pause_state[motor_index] = PAUSE_NONE;
+		start_rotation(m_paused_steps[motor_index], motor_index);
+		resumed = true;
+	}
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	return resumed;
+}
+
+void pause_discard (uint8_t motor_index)
+{
+	m_pause_state[motor_index] = PAUSE_NONE;
+}
+
+uint8_t get_paused_motors (void)
+{
+	uint8_t motors_mask = 0;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (m_pause_state[i] != PAUSE_NONE)
+			motors_mask |= (1 << i);
+	}
+	
+	return motors_mask;
 }
 
 bool if_moving_stop_rotation (uint8_t motor_index)
@@ -229,83 +513,250 @@ void send_motors_stopped_event (uint8_t motor_stop_bit_mask)
 
 
 /************************************************************************/
-/* Update motion                                                        */
+/* Ramped immediate steps                                               */
 /************************************************************************/
-int32_t user_sent_request (int32_t requested_steps, uint8_t motor_index)
+void immediate_steps_ramp (int32_t step_interval_us, uint16_t ramp_interval_us, uint8_t motor_index)
 {
-	if (!motor_is_running[motor_index])
+	TC0_t* timer = motor_peripherals_timer[motor_index];
+	
+	uint16_t target = (uint16_t)(((step_interval_us < 0) ? -step_interval_us : step_interval_us) >> 1);
+	uint16_t ramp = ramp_interval_us >> 1;
+	
+	if (ramp == 0) ramp = 1;
+	
+	/* Disable all interrupt levels so the step interrupt sees a consistent target */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm;
+	
+	m_immediate_target_interval[motor_index] = target;
+	m_immediate_target_positive[motor_index] = (step_interval_us > 0) ? true : false;
+	m_immediate_ramp_interval[motor_index] = ramp;
+	
+	if (timer->CTRLA == 0)
 	{
-		start_rotation(requested_steps, motor_index);
-		return 0;
+		if (target == 0)
+		{
+			m_immediate_ramp_interval[motor_index] = 0;
+		}
+		else
+		{
+			if (step_interval_us > 0)
+				motor_peripherals_dir_port[motor_index]->OUTSET = (1<<motor_peripherals_dir_pin_index[motor_index]);
+			else
+				motor_peripherals_dir_port[motor_index]->OUTCLR = (1<<motor_peripherals_dir_pin_index[motor_index]);
+			
+			/* Starts at the initial interval, or at the target if it's slower */
+			timer_type0_pwm(timer, TIMER_PRESCALER_DIV64, (target > m_max_pulse_interval_us[motor_index]) ? target : m_max_pulse_interval_us[motor_index], 3, INT_LEVEL_LOW, INT_LEVEL_OFF);
+			
+			if (core_bool_is_visual_enabled())
+			{
+				motor_peripherals_led_port[motor_index]->OUTSET = (1<<motor_peripherals_led_pin_index[motor_index]);
+			}
+		}
 	}
+	else if (timer->INTCTRLB != 0 || (motor_index == 1 && m1_quick_count_down) || (motor_index == 2 && m2_quick_count_down))
+	{
+		/* A running move continues from its current speed, with the same state as a stopped motor */
+		timer->INTCTRLB = 0;
+		motor_is_running[motor_index] = false;
+		blended_move_abort(motor_index);
+		pause_discard(motor_index);
+		
+		steps_count[motor_index] = 0;
+		steps_target[motor_index] = 0;
+		steps_remaining[motor_index] = 0;
+		m_reverse_steps[motor_index] = 0;
+		decreasing_speed[motor_index] = false;
+		
+		if (motor_index == 1) m1_quick_count_down = 0;
+		if (motor_index == 2) m2_quick_count_down = 0;
+		
+		/* The overflow interrupt runs at the low level, as when immediate steps start from rest */
+		timer->INTCTRLA = (timer->INTCTRLA & ~TC0_OVFINTLVL_gm) | TC_OVFINTLVL_LO_gc;
+	}
+	
+	PMIC_CTRL = pmic_ctrl;
+}
+
+void immediate_steps_ramp_cancel (uint8_t motor_index)
+{
+	m_immediate_ramp_interval[motor_index] = 0;
+}
+
+void immediate_steps_watchdog_feed (uint8_t motor_index, bool running)
+{
+	m_immediate_watchdog_ms[motor_index] = 0;
+	
+	if (running)
+		m_immediate_watchdog_mask |= (1 << motor_index);
 	else
+		m_immediate_watchdog_mask &= ~(1 << motor_index);
+}
+
+void immediate_steps_watchdog_process (void)
+{
+	uint8_t expired_mask = 0;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
 	{
-		if ((requested_steps > 0) && (moving_positive[motor_index] == true))
-		{
-			steps_target[motor_index] += requested_steps;
-			return 0;
-		}
+		if (!(m_immediate_watchdog_mask & (1 << i)))
+			continue;
 		
-		if ((requested_steps < 0) && (moving_positive[motor_index] == false))
+		/* Stopped, or replaced by a move that doesn't depend on the host link */
+		if (motor_peripherals_timer[i]->CTRLA == 0 || motor_peripherals_timer[i]->INTCTRLB != 0)
 		{
-			steps_target[motor_index] += (uint32_t)(~requested_steps + 1);
-			return 0;
+			m_immediate_watchdog_mask &= ~(1 << i);
+			continue;
 		}
 		
-		if ((requested_steps > 0) && (moving_positive[motor_index] == false))
+		if (app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[i] == 0)
+			continue;
+		
+		if (++m_immediate_watchdog_ms[i] < app_regs.REG_IMMEDIATE_STEPS_TIMEOUT[i])
+			continue;
+		
+		/* Decelerate with the immediate steps ramp, or with the motor's acceleration if there is none */
+		uint16_t ramp_interval = app_regs.REG_IMMEDIATE_STEPS_ACCELERATION_INTERVAL[i];
+		
+		if (ramp_interval == 0)
+			ramp_interval = *((&app_regs.REG_MOTOR0_STEP_ACCELERATION_INTERVAL) + i);
+		
+		immediate_steps_ramp(0, ramp_interval, i);
+		
+		m_immediate_watchdog_mask &= ~(1 << i);
+		expired_mask |= (1 << i);
+	}
+	
+	if (expired_mask)
+	{
+		app_regs.REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED = expired_mask;
+		core_func_send_event(ADD_REG_IMMEDIATE_STEPS_TIMEOUT_EXPIRED, true);
+	}
+}
+
+static void immediate_steps_ramp_step (uint8_t motor_index)
+{
+	TC0_t* timer = motor_peripherals_timer[motor_index];
+	
+	uint32_t interval = (uint32_t)timer->PER + 1;
+	uint16_t target = m_immediate_target_interval[motor_index];
+	uint16_t ramp = m_immediate_ramp_interval[motor_index];
+	bool positive = (motor_peripherals_dir_port[motor_index]->IN & (1<<motor_peripherals_dir_pin_index[motor_index])) ? true : false;
+	
+	if (target == 0 || positive != m_immediate_target_positive[motor_index])
+	{
+		/* Decelerate until the initial interval before stopping or reversing */
+		if (interval + ramp >= m_max_pulse_interval_us[motor_index])
 		{
-			if (decreasing_speed[motor_index])
-			{
-				return requested_steps;
-			}
-			else if (steps_count[motor_index] <= ramp_steps[motor_index])
+			if (target == 0)
 			{
-				return requested_steps;
+				stop_rotation(motor_index);
+				send_motor_stopped_notification[motor_index] = true;
+				return;
 			}
+			
+			if (positive)
+				motor_peripherals_dir_port[motor_index]->OUTCLR = (1<<motor_peripherals_dir_pin_index[motor_index]);
 			else
-			{
-				uint32_t available_steps_to_decrease = steps_remaining[motor_index] - ramp_steps[motor_index] - 1;
-				
-				if (requested_steps <= available_steps_to_decrease)
-				{
-					steps_target[motor_index] -= requested_steps;
-					return 0;
-				}
-				else
-				{
-					steps_target[motor_index] -= available_steps_to_decrease;
-					return requested_steps - available_steps_to_decrease;
-				}
-			}
+				motor_peripherals_dir_port[motor_index]->OUTSET = (1<<motor_peripherals_dir_pin_index[motor_index]);
+			
+			interval = (target > m_max_pulse_interval_us[motor_index]) ? target : m_max_pulse_interval_us[motor_index];
+		}
+		else
+		{
+			interval += ramp;
+		}
+	}
+	else if (interval > target)
+	{
+		interval = (interval - target > ramp) ? interval - ramp : target;
+	}
+	else if (interval < target)
+	{
+		interval = (target - interval > ramp) ? interval + ramp : target;
+	}
+	
+	timer->PER = interval - 1;
+}
+
+
+/************************************************************************/
+/* Update motion                                                        */
+/************************************************************************/
+static int32_t user_sent_request_update (int32_t requested_steps, uint8_t motor_index)
+{
+	/* A new move replaces the paused one */
+	pause_discard(motor_index);
+	
+	/* Wait until the blended moves are done */
+	if (blended_move_running_mask & (1 << motor_index))
+	{
+		return requested_steps;
+	}
+	
+	if (!motor_is_running[motor_index])
+	{
+		start_rotation(requested_steps, motor_index);
+		return 0;
+	}
+	
+	/* Requests in the direction of the pending reversal are added to it, the others cancel it first */
+	if (m_reverse_steps[motor_index] != 0)
+	{
+		if ((requested_steps > 0) == (m_reverse_steps[motor_index] > 0))
+		{
+			m_reverse_steps[motor_index] += requested_steps;
+			return 0;
 		}
 		
-		if ((requested_steps < 0) && (moving_positive[motor_index] == true))
+		if (labs(requested_steps) <= labs(m_reverse_steps[motor_index]))
 		{
-			if (decreasing_speed[motor_index])
-			{
-				return requested_steps;
-			}
-			else if (steps_count[motor_index] <= ramp_steps[motor_index])
-			{
-				return requested_steps;
-			}
-			else
-			{
-				uint32_t available_steps_to_decrease = steps_remaining[motor_index] - ramp_steps[motor_index] - 1;
-				
-				if ((~requested_steps+1) <= available_steps_to_decrease)
-				{
-					steps_target[motor_index] -= (uint32_t)(~requested_steps + 1);
-					return 0;
-				}
-				else
-				{
-					steps_target[motor_index] -= available_steps_to_decrease;
-					return requested_steps + available_steps_to_decrease;
-				}
-			}
+			m_reverse_steps[motor_index] += requested_steps;
+			return 0;
 		}
+		
+		requested_steps += m_reverse_steps[motor_index];
+		m_reverse_steps[motor_index] = 0;
 	}
+	
+	if ((requested_steps > 0) == moving_positive[motor_index])
+	{
+		steps_target[motor_index] += (uint32_t)labs(requested_steps);
+		clamp_target_to_travel_limits(motor_index);
+		return 0;
+	}
+	
+	/* Opposite direction: shorten the move as much as the deceleration allows */
+	uint32_t reverse = (uint32_t)labs(requested_steps);
+	uint32_t steps_left = steps_target[motor_index] - steps_count[motor_index];
+	uint32_t steps_to_stop = get_steps_to_stop(motor_index);
+	uint32_t available_steps_to_decrease = (steps_left > steps_to_stop) ? steps_left - steps_to_stop : 0;
+	
+	if (reverse <= available_steps_to_decrease)
+	{
+		steps_target[motor_index] -= reverse;
+		return 0;
+	}
+	
+	/* The rest runs in the new direction, the step interrupt reverses when the motor reaches the maximum interval */
+	steps_target[motor_index] -= available_steps_to_decrease;
+	reverse -= available_steps_to_decrease;
+	m_reverse_steps[motor_index] = moving_positive[motor_index] ? -(int32_t)reverse : (int32_t)reverse;
+	
+	return 0;
+}
+
+int32_t user_sent_request (int32_t requested_steps, uint8_t motor_index)
+{
+	/* Disable medium and high level interrupts, the step interrupts also change the target, direction and reversal */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	requested_steps = user_sent_request_update(requested_steps, motor_index);
+	
+	PMIC_CTRL = pmic_ctrl;
+	
+	return requested_steps;
 }
 
 /************************************************************************/
@@ -319,7 +770,9 @@ void manage_step_boundaries (uint8_t motor_index)
 		
 		if (*((&app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION) + motor_index) != 0)
 		{
-			if (*(app_regs.REG_ACCUMULATED_STEPS + motor_index) >= *((&app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION) + motor_index))
+			/* Moves that follow steps_target are clamped to end on the limit, so they only stop here if they go past it */
+			if ((*(app_regs.REG_ACCUMULATED_STEPS + motor_index) > *((&app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION) + motor_index)) ||
+				(*(app_regs.REG_ACCUMULATED_STEPS + motor_index) == *((&app_regs.REG_MOTOR0_MAX_STEPS_INTEGRATION) + motor_index) && motor_peripherals_timer[motor_index]->INTCTRLB == 0))
 			{
 				stop_rotation(motor_index);
 				
@@ -334,7 +787,8 @@ void manage_step_boundaries (uint8_t motor_index)
 		
 		if (*((&app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION) + motor_index) != 0)
 		{
-			if (*(app_regs.REG_ACCUMULATED_STEPS + motor_index) <= *((&app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION) + motor_index))
+			if ((*(app_regs.REG_ACCUMULATED_STEPS + motor_index) < *((&app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION) + motor_index)) ||
+				(*(app_regs.REG_ACCUMULATED_STEPS + motor_index) == *((&app_regs.REG_MOTOR0_MIN_STEPS_INTEGRATION) + motor_index) && motor_peripherals_timer[motor_index]->INTCTRLB == 0))
 			{
 				stop_rotation(motor_index);
 				
@@ -345,15 +799,75 @@ void manage_step_boundaries (uint8_t motor_index)
 	}
 }
 
+/************************************************************************/
+/* Backlash compensation                                                */
+/************************************************************************/
+static void backlash_update_direction (uint8_t motor_index)
+{
+	uint8_t motor_mask = (1 << motor_index);
+	bool positive = (motor_peripherals_dir_port[motor_index]->IN & (1<<motor_peripherals_dir_pin_index[motor_index])) ? true : false;
+	
+	if ((m_backlash_known_mask & motor_mask) && (((m_backlash_positive_mask & motor_mask) ? true : false) != positive))
+	{
+		uint16_t backlash = app_regs.REG_BACKLASH_STEPS[motor_index];
+		
+		/* Reversing before the slack was taken up only needs the steps already done */
+		m_backlash_remaining[motor_index] = (m_backlash_remaining[motor_index] < backlash) ? backlash - m_backlash_remaining[motor_index] : 0;
+	}
+	
+	m_backlash_known_mask |= motor_mask;
+	
+	if (positive)
+		m_backlash_positive_mask |= motor_mask;
+	else
+		m_backlash_positive_mask &= ~motor_mask;
+}
+
+bool backlash_step (uint8_t motor_index)
+{
+	backlash_update_direction(motor_index);
+	
+	if (m_backlash_remaining[motor_index])
+	{
+		m_backlash_remaining[motor_index]--;
+		return true;
+	}
+	
+	return false;
+}
+
+uint16_t backlash_take_up (uint8_t motor_index)
+{
+	backlash_update_direction(motor_index);
+	
+	uint16_t steps = m_backlash_remaining[motor_index];
+	m_backlash_remaining[motor_index] = 0;
+	
+	return steps;
+}
+
+
 /************************************************************************/
 /* Interrupts                                                           */
 /************************************************************************/
 void timer_ovf_routine (uint8_t motor_index)
 {	
+	/* Compensation steps run at the current interval and don't count as steps of the move */
+	if (backlash_step(motor_index))
+	{
+		return;
+	}
+	
 	if (motor_peripherals_timer[motor_index]->INTCTRLB == 0)
 	{
 		manage_step_boundaries(motor_index);
 		
+		/* Slew the ramped immediate steps to their target interval */
+		if (m_immediate_ramp_interval[motor_index] && motor_peripherals_timer[motor_index]->CTRLA != 0)
+		{
+			immediate_steps_ramp_step(motor_index);
+		}
+		
 		return;
 	}
 	
@@ -366,14 +880,38 @@ void timer_ovf_routine (uint8_t motor_index)
 	
 	steps_remaining[motor_index] = steps_target[motor_index] - steps_count[motor_index];
 	
-	if ((steps_remaining[motor_index] <= steps_count[motor_index]) && (steps_remaining[motor_index] <= ramp_steps[motor_index]))
+	uint16_t interval = m_profile_interval[motor_index];
+	
+	if (blended_move_running_mask & (1 << motor_index))
+	{
+		uint16_t exit_interval = blended_move_exit_interval[motor_index];
+		uint16_t nominal_interval = blended_move_nominal_interval[motor_index];
+		
+		/* Decelerate when the remaining steps are just enough to reach the interval planned for the junction */
+		decreasing_speed[motor_index] = (exit_interval > interval) && (steps_remaining[motor_index] <= 0xFFFF) &&
+			((uint32_t)steps_remaining[motor_index] * m_pulse_step_interval_us[motor_index] <= exit_interval - interval);
+		
+		if (decreasing_speed[motor_index])
+		{
+			interval = (interval + m_pulse_step_interval_us[motor_index] > exit_interval)? exit_interval : interval + m_pulse_step_interval_us[motor_index];
+		}
+		else if (interval > nominal_interval)
+		{
+			interval = (interval - m_pulse_step_interval_us[motor_index] < nominal_interval)? nominal_interval : interval - m_pulse_step_interval_us[motor_index];
+		}
+		else if (interval < nominal_interval)
+		{
+			interval = (interval + m_pulse_step_interval_us[motor_index] > nominal_interval)? nominal_interval : interval + m_pulse_step_interval_us[motor_index];
+		}
+	}
+	else if ((steps_remaining[motor_index] <= steps_count[motor_index]) && (steps_remaining[motor_index] <= ramp_steps[motor_index]))
 	{
 		decreasing_speed[motor_index] = true;
 		
 		/* Decrease motor speed */
-		if (motor_peripherals_timer[motor_index]->PER < m_max_pulse_interval_us[motor_index])
+		if (interval < m_max_pulse_interval_us[motor_index])
 		{
-			motor_peripherals_timer[motor_index]->PER = (motor_peripherals_timer[motor_index]->PER + m_pulse_step_interval_us[motor_index] > m_max_pulse_interval_us[motor_index])? m_max_pulse_interval_us[motor_index] : motor_peripherals_timer[motor_index]->PER + m_pulse_step_interval_us[motor_index];
+			interval = (interval + m_pulse_step_interval_us[motor_index] > m_max_pulse_interval_us[motor_index])? m_max_pulse_interval_us[motor_index] : interval + m_pulse_step_interval_us[motor_index];
 		}
 	}
 	else
@@ -381,20 +919,67 @@ void timer_ovf_routine (uint8_t motor_index)
 		decreasing_speed[motor_index] = false;
 		
 		/* Increase motor speed */
-		if (motor_peripherals_timer[motor_index]->PER > m_min_pulse_interval_us[motor_index])
+		if (interval > m_min_pulse_interval_us[motor_index])
 		{
-			motor_peripherals_timer[motor_index]->PER = (motor_peripherals_timer[motor_index]->PER - m_pulse_step_interval_us[motor_index] < m_min_pulse_interval_us[motor_index])? m_min_pulse_interval_us[motor_index] : motor_peripherals_timer[motor_index]->PER - m_pulse_step_interval_us[motor_index];
+			interval = (interval - m_pulse_step_interval_us[motor_index] < m_min_pulse_interval_us[motor_index])? m_min_pulse_interval_us[motor_index] : interval - m_pulse_step_interval_us[motor_index];
 		}
 	}
+	
+	m_profile_interval[motor_index] = interval;
+	
+	/* The feed rate override is applied at every step, so it also changes the speed while cruising */
+	motor_peripherals_timer[motor_index]->PER = feed_rate_scale_interval(interval, motor_index, FEED_RATE_MINIMUM_INTERVAL);
 }
 
 void timer_cca_routine (uint8_t motor_index)
 {
 	if (steps_count[motor_index] == steps_target[motor_index])
 	{
+		/* Blended moves continue with the next one without stopping */
+		if ((blended_move_running_mask & (1 << motor_index)) && blended_move_next(motor_index))
+		{
+			/* The limits may have changed since the move was queued */
+			clamp_target_to_travel_limits(motor_index);
+			return;
+		}
+		
+		bool pausing = (m_pause_state[motor_index] == PAUSE_DECELERATING) ? true : false;
+		
+		if (!pausing && m_reverse_steps[motor_index] != 0)
+		{
+			m_reverse_steps[motor_index] = clamp_to_travel_limits(m_reverse_steps[motor_index], app_regs.REG_ACCUMULATED_STEPS[motor_index], motor_index);
+		}
+		
+		/* Reverse at the maximum interval and accelerate in the new direction */
+		if (!pausing && m_reverse_steps[motor_index] != 0)
+		{
+			if (m_reverse_steps[motor_index] > 0)
+			{
+				motor_peripherals_dir_port[motor_index]->OUTSET = (1<<motor_peripherals_dir_pin_index[motor_index]);
+				moving_positive[motor_index] = true;
+				steps_target[motor_index] = (uint32_t)m_reverse_steps[motor_index];
+			}
+			else
+			{
+				motor_peripherals_dir_port[motor_index]->OUTCLR = (1<<motor_peripherals_dir_pin_index[motor_index]);
+				moving_positive[motor_index] = false;
+				steps_target[motor_index] = (uint32_t)(-m_reverse_steps[motor_index]);
+			}
+			
+			steps_count[motor_index] = 0;
+			m_reverse_steps[motor_index] = 0;
+			decreasing_speed[motor_index] = false;
+			return;
+		}
+		
+		/* The paused move also keeps the pending reversal */
+		if (pausing) m_paused_steps[motor_index] += m_reverse_steps[motor_index];
+		
 		/* Stop motor */
 		stop_rotation(motor_index);
 		
+		if (pausing) m_pause_state[motor_index] = PAUSE_STOPPED;
+		
 		/* Since this is used at MID level interrupts, send an event from here can happen in the middle of other event */
 		send_motor_stopped_notification[motor_index] = true;
 	}
@@ -508,6 +1093,13 @@ ISR(TCD0_OVF_vect/*, ISR_NAKED*/)
 	
 	if (m1_quick_count_down)
 	{
+		/* Backlash pulses keep the start interval and don't count as steps of the move */
+		if (m1_quick_backlash_pulses)
+		{
+			m1_quick_backlash_pulses--;
+			return;
+		}
+		
 		/* Run time is 2 us for the entire interrupt */
 		if (read_DIR_M1 > 0)
 		{
@@ -695,7 +1287,7 @@ ISR(TCD0_OVF_vect/*, ISR_NAKED*/)
 				m1_delay = m1_delay_temp;
 		
 				//clr_STEP_M2;
-				TCD0_PER = (m1_delay >> 1) - 1;
+				TCD0_PER = feed_rate_scale_interval(m1_delay >> 1, 1, FEED_RATE_QUICK_MINIMUM_INTERVAL) - 1;
 			
 				if (m1_delay >= MOVE_TO_STEPS_PERIOD)
 				{
@@ -779,7 +1371,7 @@ ISR(TCD0_OVF_vect/*, ISR_NAKED*/)
 			//m1_delay_temp = 1000000.0/m1_speed;	// 28.4us max
 		
 			
-			TCD0_PER = (m1_delay >> 1) - 1;
+			TCD0_PER = feed_rate_scale_interval(m1_delay >> 1, 1, FEED_RATE_QUICK_MINIMUM_INTERVAL) - 1;
 			
 			if (m1_delay <= MOVE_TO_STEPS_PERIOD)
 			{
@@ -829,6 +1421,13 @@ ISR(TCE0_OVF_vect/*, ISR_NAKED*/)
 	
 	if (m2_quick_count_down)
 	{
+		/* Backlash pulses keep the start interval and don't count as steps of the move */
+		if (m2_quick_backlash_pulses)
+		{
+			m2_quick_backlash_pulses--;
+			return;
+		}
+		
 		/* Run time is 2 us for the entire interrupt */
 		if (read_DIR_M2 > 0)
 		{
@@ -1016,7 +1615,7 @@ ISR(TCE0_OVF_vect/*, ISR_NAKED*/)
 				m2_delay = m2_delay_temp;
 		
 				//clr_STEP_M2;
-				TCE0_PER = (m2_delay >> 1) - 1;
+				TCE0_PER = feed_rate_scale_interval(m2_delay >> 1, 2, FEED_RATE_QUICK_MINIMUM_INTERVAL) - 1;
 			
 				if (m2_delay >= MOVE_TO_STEPS_PERIOD)
 				{
@@ -1100,7 +1699,7 @@ ISR(TCE0_OVF_vect/*, ISR_NAKED*/)
 			//m1_delay_temp = 1000000.0/m1_speed;	// 28.4us max
 		
 			
-			TCE0_PER = (m2_delay >> 1) - 1;
+			TCE0_PER = feed_rate_scale_interval(m2_delay >> 1, 2, FEED_RATE_QUICK_MINIMUM_INTERVAL) - 1;
 			
 			if (m2_delay <= MOVE_TO_STEPS_PERIOD)
 			{
@@ -17,6 +17,11 @@
 // Define number of available motors
 #define MOTORS_QUANTITY 4
 
+// States of the paused moves
+#define PAUSE_NONE 0
+#define PAUSE_DECELERATING 1
+#define PAUSE_STOPPED 2
+
 /************************************************************************/
 /* Update global electrical pulse parameters                            */
 /************************************************************************/
@@ -27,6 +32,15 @@ bool update_initial_pulse_interval (uint16_t time_us, uint8_t motor_index);
 bool update_pulse_step_interval (uint16_t time_us, uint8_t motor_index);
 bool update_pulse_period (uint16_t time_us, uint8_t motor_index);
 
+/************************************************************************/
+/* Travel limits                                                        */
+/************************************************************************/
+/* Returns the steps that keep the motor within REG_MOTORn_MIN/MAX_STEPS_INTEGRATION */
+int32_t clamp_to_travel_limits (int32_t requested_steps, int32_t position, uint8_t motor_index);
+
+/* Clamps the running move after the limits change */
+void travel_limits_update (uint8_t motor_index);
+
 /************************************************************************/
 /* Start & Stop functions                                               */
 /************************************************************************/
@@ -36,15 +50,43 @@ void reduce_until_stop_rotation (uint8_t motor_index);
 
 bool if_moving_stop_rotation (uint8_t motor_index);
 
+/* Decelerates until stop keeping the rest of the move, which resume_rotation() completes */
+bool pause_rotation (uint8_t motor_index);
+bool resume_rotation (uint8_t motor_index);
+void pause_discard (uint8_t motor_index);
+uint8_t get_paused_motors (void);
+
 bool is_timer_ready (uint8_t motor_index);
 
 void send_motors_stopped_event (uint8_t motor_stop_bit_mask);
 
+/************************************************************************/
+/* Ramped immediate steps                                               */
+/************************************************************************/
+/* Slews the step interval to the target in the step interrupt, a target of 0 decelerates until stop */
+void immediate_steps_ramp (int32_t step_interval_us, uint16_t ramp_interval_us, uint8_t motor_index);
+void immediate_steps_ramp_cancel (uint8_t motor_index);
+
+/* Decelerates the motors whose immediate steps weren't updated within REG_IMMEDIATE_STEPS_TIMEOUT */
+void immediate_steps_watchdog_feed (uint8_t motor_index, bool running);
+
+/* Called every 1 ms */
+void immediate_steps_watchdog_process (void);
+
 /************************************************************************/
 /* Update motion                                                        */
 /************************************************************************/
 int32_t user_sent_request (int32_t requested_steps, uint8_t motor_index);
 
+/************************************************************************/
+/* Backlash compensation                                                */
+/************************************************************************/
+/* Called at each step, returns true if the step takes up the backlash after a direction change */
+bool backlash_step (uint8_t motor_index);
+
+/* Called when a quick movement starts, returns the steps to take up before its profile and clears them */
+uint16_t backlash_take_up (uint8_t motor_index);
+
 /************************************************************************/
 /* Manage boundaries                                                    */
 /************************************************************************/
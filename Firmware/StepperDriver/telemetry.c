@@ -0,0 +1,323 @@
+#include "telemetry.h"
+#include "stepper_control.h"
+#include "encoders.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+// Number of core ticks (500 us) between frames for each GM_RATE_ value
+const uint8_t telemetry_rate_period[4] = {20, 10, 8, 4};
+
+uint8_t telemetry_tick_counter = 0;
+uint8_t telemetry_frames_since_keyframe = 0;
+bool telemetry_keyframe_pending = true;
+
+// Values known by the host after the last frame
+int32_t telemetry_sent[TELEMETRY_CHANNELS];
+uint8_t telemetry_state_sent;
+
+// Values and core ticks since the last on-change events
+int32_t telemetry_steps_sent[MOTORS_QUANTITY];
+int32_t telemetry_encoders_sent[ENCODERS_QUANTITY];
+uint32_t telemetry_ticks_since_steps = 0;
+uint32_t telemetry_ticks_since_encoders = 0;
+uint32_t telemetry_ticks_since_frame = 0;
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+/* Returns the stopped motors on the lower nibble and the digital inputs on the upper nibble */
+static uint8_t telemetry_sample (int32_t *values)
+{
+	uint8_t state = 0;
+	
+	/* Disable medium and high level interrupts so the motors don't change while copied */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		values[i] = app_regs.REG_ACCUMULATED_STEPS[i];
+		
+		if (motor_peripherals_timer[i]->CTRLA == 0)
+			state |= (1 << i);
+	}
+	
+	/* Re-enable all interrupt levels */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		values[MOTORS_QUANTITY + i] = encoders_get_sampled_position(i);
+	}
+	
+	/* The inputs are active low */
+	if (!read_INPUT0) state |= (B_INPUT0 << 4);
+	if (!read_INPUT1) state |= (B_INPUT1 << 4);
+	if (!read_INPUT2) state |= (B_INPUT2 << 4);
+	if (!read_INPUT3) state |= (B_INPUT3 << 4);
+	
+	return state;
+}
+
+static bool telemetry_moved (int32_t *values, int32_t *sent, uint8_t quantity, uint16_t deadband)
+{
+	for (uint8_t i = 0; i < quantity; i++)
+	{
+		int32_t delta = values[i] - sent[i];
+		
+		if (delta > deadband || delta < -(int32_t)deadband)
+		{
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+static bool telemetry_heartbeat_is_due (uint32_t ticks)
+{
+	if (app_regs.REG_EVENTS_HEARTBEAT_INTERVAL == 0)
+	{
+		return false;
+	}
+	
+	/* Each core tick is 500 us */
+	return (ticks >= (uint32_t)app_regs.REG_EVENTS_HEARTBEAT_INTERVAL * 2) ? true : false;
+}
+
+static void telemetry_count_tick (uint32_t *ticks)
+{
+	if (*ticks != 0xFFFFFFFF)
+	{
+		(*ticks)++;
+	}
+}
+
+static void telemetry_send_delta_frame (int32_t *values)
+{
+	bool wide_deltas = false;
+	
+	if (!telemetry_keyframe_pending)
+	{
+		for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++)
+		{
+			int32_t delta = values[i] - telemetry_sent[i];
+			
+			/* Differences that don't fit in 16 bits are only expected after long pauses or large position writes */
+			if (delta > 32767 || delta < -32768)
+			{
+				telemetry_keyframe_pending = true;
+				break;
+			}
+			
+			if (delta > 127 || delta < -128)
+			{
+				wide_deltas = true;
+			}
+			
+			app_regs.REG_TELEMETRY_WIDE_DELTAS[i] = (int16_t)delta;
+		}
+	}
+	
+	if (telemetry_keyframe_pending)
+	{
+		for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++)
+		{
+			app_regs.REG_TELEMETRY_KEYFRAME[i] = values[i];
+		}
+		
+		core_func_send_event(ADD_REG_TELEMETRY_KEYFRAME, true);
+		
+		telemetry_keyframe_pending = false;
+		telemetry_frames_since_keyframe = 0;
+	}
+	else
+	{
+		/* The 8-bit differences are sent whenever possible to keep the bandwidth low */
+		if (wide_deltas)
+		{
+			core_func_send_event(ADD_REG_TELEMETRY_WIDE_DELTAS, true);
+		}
+		else
+		{
+			for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++)
+			{
+				app_regs.REG_TELEMETRY_DELTAS[i] = (int8_t)app_regs.REG_TELEMETRY_WIDE_DELTAS[i];
+			}
+			
+			core_func_send_event(ADD_REG_TELEMETRY_DELTAS, true);
+		}
+		
+		if (++telemetry_frames_since_keyframe >= app_regs.REG_TELEMETRY_KEYFRAME_INTERVAL)
+		{
+			telemetry_keyframe_pending = true;
+		}
+	}
+}
+
+static void telemetry_send_frame (int32_t *values, uint8_t state)
+{
+	uint8_t fields = app_regs.REG_TELEMETRY_FRAME_FIELDS;
+	int32_t *frame = app_regs.REG_TELEMETRY_FRAME;
+	
+	/* Every field has a fixed position, the fields not selected are sent as 0 */
+	*frame++ = fields;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+		*frame++ = (fields & B_FRAME_ACCUMULATED_STEPS) ? values[i] : 0;
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+		*frame++ = (fields & B_FRAME_ENCODERS_POSITION) ? values[MOTORS_QUANTITY + i] : 0;
+	
+	/* The velocities keep their 4 fractional bits */
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+		*frame++ = (fields & B_FRAME_ENCODERS_VELOCITY) ? encoders_get_velocity_fixed(i) : 0;
+	
+	*frame++ = (fields & B_FRAME_MOTORS_STOPPED) ? (state & 0x0F) : 0;
+	*frame++ = (fields & B_FRAME_DIGITAL_INPUTS) ? (state >> 4) : 0;
+	
+	core_func_send_event(ADD_REG_TELEMETRY_FRAME, true);
+	
+	telemetry_keyframe_pending = false;
+}
+
+
+/************************************************************************/
+/* Telemetry routines                                                   */
+/************************************************************************/
+void telemetry_restart (void)
+{
+	telemetry_tick_counter = 0;
+	telemetry_keyframe_pending = true;
+}
+
+bool telemetry_delta_stream_is_enabled (void)
+{
+	return (app_regs.REG_TELEMETRY_MODE == GM_TELEMETRY_DELTA) ? true : false;
+}
+
+bool telemetry_accumulated_steps_is_due (void)
+{
+	if (!(app_regs.REG_EVENTS_ON_CHANGE & B_ON_CHANGE_ACCUMULATED_STEPS))
+	{
+		return true;
+	}
+	
+	int32_t steps[MOTORS_QUANTITY];
+	
+	/* Disable medium and high level interrupts so the steps don't change while copied */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		steps[i] = app_regs.REG_ACCUMULATED_STEPS[i];
+	}
+	
+	/* Re-enable all interrupt levels */
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+	
+	if (!telemetry_moved(steps, telemetry_steps_sent, MOTORS_QUANTITY, app_regs.REG_ACCUMULATED_STEPS_DEADBAND) &&
+		!telemetry_heartbeat_is_due(telemetry_ticks_since_steps))
+	{
+		return false;
+	}
+	
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		telemetry_steps_sent[i] = steps[i];
+	}
+	
+	telemetry_ticks_since_steps = 0;
+	
+	return true;
+}
+
+bool telemetry_encoders_is_due (void)
+{
+	if (!(app_regs.REG_EVENTS_ON_CHANGE & B_ON_CHANGE_ENCODERS))
+	{
+		return true;
+	}
+	
+	int32_t positions[ENCODERS_QUANTITY];
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		positions[i] = encoders_get_sampled_position(i);
+	}
+	
+	if (!telemetry_moved(positions, telemetry_encoders_sent, ENCODERS_QUANTITY, app_regs.REG_ENCODERS_DEADBAND) &&
+		!telemetry_heartbeat_is_due(telemetry_ticks_since_encoders))
+	{
+		return false;
+	}
+	
+	for (uint8_t i = 0; i < ENCODERS_QUANTITY; i++)
+	{
+		telemetry_encoders_sent[i] = positions[i];
+	}
+	
+	telemetry_ticks_since_encoders = 0;
+	
+	return true;
+}
+
+void telemetry_process (void)
+{
+	telemetry_count_tick(&telemetry_ticks_since_steps);
+	telemetry_count_tick(&telemetry_ticks_since_encoders);
+	telemetry_count_tick(&telemetry_ticks_since_frame);
+	
+	if (app_regs.REG_TELEMETRY_MODE == GM_TELEMETRY_DISABLED)
+	{
+		return;
+	}
+	
+	if (++telemetry_tick_counter < telemetry_rate_period[app_regs.REG_TELEMETRY_RATE])
+	{
+		return;
+	}
+	
+	telemetry_tick_counter = 0;
+	
+	int32_t values[TELEMETRY_CHANNELS];
+	uint8_t state = telemetry_sample(values);
+	
+	if ((app_regs.REG_EVENTS_ON_CHANGE & B_ON_CHANGE_TELEMETRY) && !telemetry_keyframe_pending)
+	{
+		/* The state is only part of the combined frame */
+		bool state_changed = (app_regs.REG_TELEMETRY_MODE == GM_TELEMETRY_FRAME && state != telemetry_state_sent) ? true : false;
+		
+		if (!state_changed &&
+			!telemetry_moved(values, telemetry_sent, MOTORS_QUANTITY, app_regs.REG_ACCUMULATED_STEPS_DEADBAND) &&
+			!telemetry_moved(values + MOTORS_QUANTITY, telemetry_sent + MOTORS_QUANTITY, ENCODERS_QUANTITY, app_regs.REG_ENCODERS_DEADBAND) &&
+			!telemetry_heartbeat_is_due(telemetry_ticks_since_frame))
+		{
+			return;
+		}
+	}
+	
+	if (app_regs.REG_TELEMETRY_MODE == GM_TELEMETRY_FRAME)
+	{
+		telemetry_send_frame(values, state);
+	}
+	else
+	{
+		telemetry_send_delta_frame(values);
+	}
+	
+	for (uint8_t i = 0; i < TELEMETRY_CHANNELS; i++)
+	{
+		telemetry_sent[i] = values[i];
+	}
+	
+	telemetry_state_sent = state;
+	telemetry_ticks_since_frame = 0;
+}
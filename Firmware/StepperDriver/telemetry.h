@@ -0,0 +1,36 @@
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* User mandatory definitions                                           */
+/************************************************************************/
+// Accumulated steps of the 4 motors followed by the positions of the 3 encoders
+#define TELEMETRY_CHANNELS 7
+
+/************************************************************************/
+/* Telemetry routines                                                   */
+/************************************************************************/
+/* Forces a keyframe on the next frame */
+void telemetry_restart (void);
+
+/* Called at every core tick, after encoders_update() */
+void telemetry_process (void);
+
+/* The delta stream replaces the periodic REG_ENCODERS, REG_ENCODERS_POSITION and REG_ACCUMULATED_STEPS events */
+bool telemetry_delta_stream_is_enabled (void);
+
+/* Used by the periodic events to know if they should be sent when on-change is enabled */
+bool telemetry_accumulated_steps_is_due (void);
+bool telemetry_encoders_is_due (void);
+
+#endif /* _TELEMETRY_H_ */
@@ -0,0 +1,195 @@
+#include "stepper_control.h"
+#include "quick_movement.h"
+#include "homing.h"
+#include "triggered_move.h"
+#include "app_ios_and_regs.h"
+#include "hwbp_core.h"
+
+extern AppRegs app_regs;
+
+extern TC0_t* motor_peripherals_timer[MOTORS_QUANTITY];
+extern int32_t user_requested_steps[MOTORS_QUANTITY];
+
+extern uint8_t m1_quick_count_down;
+extern uint8_t m2_quick_count_down;
+
+extern uint16_t m1_move_pulses;
+extern uint16_t m2_move_pulses;
+extern bool m1_move_positive;
+extern bool m2_move_positive;
+
+/************************************************************************/
+/* Global variables                                                     */
+/************************************************************************/
+uint8_t triggered_moves_armed = 0;
+
+
+/************************************************************************/
+/* Local routines                                                       */
+/************************************************************************/
+static bool triggered_move_motor_is_ready (uint8_t motor_index)
+{
+	bool drive_disabled;
+
+	switch (motor_index)
+	{
+		case 0:  drive_disabled = read_DRIVE_ENABLE_M0; break;
+		case 1:  drive_disabled = read_DRIVE_ENABLE_M1; break;
+		case 2:  drive_disabled = read_DRIVE_ENABLE_M2; break;
+		default: drive_disabled = read_DRIVE_ENABLE_M3; break;
+	}
+
+	if (drive_disabled)
+		return false;
+
+	/* Triggered moves only start from rest */
+	if (motor_peripherals_timer[motor_index]->CTRLA != 0)
+		return false;
+
+	/* A host request is about to be started by the 1 ms callback */
+	if (user_requested_steps[motor_index] != 0)
+		return false;
+
+	if (homing_is_running(motor_index))
+		return false;
+
+	if (motor_index == 1 && m1_quick_count_down) return false;
+	if (motor_index == 2 && m2_quick_count_down) return false;
+
+	return true;
+}
+
+static void triggered_move_launch_steps (uint8_t motors_mask, bool absolute)
+{
+	/* Disable medium and high level interrupts so all the motors start together */
+	uint8_t pmic_ctrl = PMIC_CTRL;
+	PMIC_CTRL = PMIC_RREN_bm | PMIC_LOLVLEN_bm;
+
+	for (uint8_t i = 0; i < MOTORS_QUANTITY; i++)
+	{
+		if (!(motors_mask & (1 << i)) || !triggered_move_motor_is_ready(i))
+			continue;
+
+		int32_t steps = app_regs.REG_TRIGGERED_MOVE_STEPS[i];
+
+		if (absolute)
+			steps -= app_regs.REG_ACCUMULATED_STEPS[i];
+
+		if (steps != 0)
+		{
+			pause_discard(i);
+			start_rotation(steps, i);
+		}
+	}
+
+	PMIC_CTRL = pmic_ctrl;
+}
+
+static bool triggered_move_quick_fits_travel_limits (uint8_t motor_index, bool positive, uint16_t pulses)
+{
+	int32_t steps = positive ? (int32_t)pulses : -(int32_t)pulses;
+	
+	/* Quick movements can't be shortened, so they only start if they end inside the limits */
+	return (clamp_to_travel_limits(steps, app_regs.REG_ACCUMULATED_STEPS[motor_index], motor_index) == steps) ? true : false;
+}
+
+static void triggered_move_launch_quick (uint8_t motors_mask)
+{
+	/* The motors are stopped, so the 1 ms countdown used by REG_START_QUICK_MOVEMENT is skipped */
+	/* The parameters were computed when armed, so no floating point is used here */
+	if ((motors_mask & B_MOTOR1) && triggered_move_motor_is_ready(1) &&
+		triggered_move_quick_fits_travel_limits(1, m1_move_positive, m1_move_pulses))
+	{
+		if (m1_load_quick_movement())
+		{
+			m1_quick_count_down = 1;
+			m1_initiate_quick_movement();
+		}
+	}
+
+	if ((motors_mask & B_MOTOR2) && triggered_move_motor_is_ready(2) &&
+		triggered_move_quick_fits_travel_limits(2, m2_move_positive, m2_move_pulses))
+	{
+		if (m2_load_quick_movement())
+		{
+			m2_quick_count_down = 1;
+			m2_initiate_quick_movement();
+		}
+	}
+}
+
+
+/************************************************************************/
+/* Triggered move routines                                              */
+/************************************************************************/
+bool triggered_move_arm (uint8_t inputs_mask)
+{
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		if (!(inputs_mask & (1 << i)))
+			continue;
+
+		uint8_t config = app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[i];
+
+		if ((config & MSK_TRIGGERED_MOVE_TYPE) == GM_TRIGGERED_MOVE_DISABLED)
+			return false;
+
+		if ((config & MSK_TRIGGERED_MOVE_TYPE) == GM_TRIGGERED_MOVE_QUICK)
+		{
+			/* Only motors 1 and 2 have quick movements */
+			if (config & (B_MOTOR0 | B_MOTOR3))
+				return false;
+
+			/* The floating point parameters are computed here to keep the interrupt short */
+			if ((config & B_MOTOR1) && !(m1_recalc_internal_paramenters() && m1_update_internal_variables()))
+				return false;
+			if ((config & B_MOTOR2) && !(m2_recalc_internal_paramenters() && m2_update_internal_variables()))
+				return false;
+		}
+	}
+
+	triggered_moves_armed = inputs_mask & 0x0F;
+
+	return true;
+}
+
+uint8_t triggered_move_get_armed (void)
+{
+	return triggered_moves_armed;
+}
+
+void triggered_move_input_edge (uint8_t input_index, bool rising)
+{
+	uint8_t input_mask = (1 << input_index);
+
+	if (!(triggered_moves_armed & input_mask))
+		return;
+
+	uint8_t config = app_regs.REG_TRIGGERED_MOVE_CONFIGURATION[input_index];
+
+	/* Only the configured edge launches the move */
+	if (((config & B_TRIGGERED_MOVE_ON_FALLING) ? !rising : rising) == false)
+		return;
+
+	/* Each arm launches a single move */
+	triggered_moves_armed &= ~input_mask;
+
+	switch (config & MSK_TRIGGERED_MOVE_TYPE)
+	{
+		case GM_TRIGGERED_MOVE_RELATIVE:
+			triggered_move_launch_steps(config & MSK_TRIGGERED_MOVE_MOTORS, false);
+			break;
+
+		case GM_TRIGGERED_MOVE_ABSOLUTE:
+			triggered_move_launch_steps(config & MSK_TRIGGERED_MOVE_MOTORS, true);
+			break;
+
+		case GM_TRIGGERED_MOVE_QUICK:
+			triggered_move_launch_quick(config & MSK_TRIGGERED_MOVE_MOTORS);
+			break;
+	}
+
+	/* Lower nibble contains the inputs still armed and the upper nibble the input that fired */
+	app_regs.REG_ARM_TRIGGERED_MOVES = triggered_moves_armed | (input_mask << 4);
+	core_func_send_event(ADD_REG_ARM_TRIGGERED_MOVES, true);
+}
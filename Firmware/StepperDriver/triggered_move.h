@@ -0,0 +1,23 @@
+#ifndef _TRIGGERED_MOVE_H_
+#define _TRIGGERED_MOVE_H_
+#include <avr/io.h>
+
+// Define if not defined
+#ifndef bool
+	#define bool uint8_t
+#endif
+#ifndef true
+	#define true 1
+	#define false 0
+#endif
+
+/************************************************************************/
+/* Triggered move routines                                              */
+/************************************************************************/
+bool triggered_move_arm (uint8_t inputs_mask);
+uint8_t triggered_move_get_armed (void);
+
+/* Called from the digital inputs' interrupts */
+void triggered_move_input_edge (uint8_t input_index, bool rising);
+
+#endif /* _TRIGGERED_MOVE_H_ */